@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+namespace dae
+{
+	namespace Benchmark
+	{
+		struct Result
+		{
+			std::string name{};
+			double nanosecondsPerItem{};
+			size_t items{};
+		};
+
+		inline volatile unsigned char g_Sink{};
+
+		// Keeps the compiler from throwing away work whose result is never used
+		template<typename T>
+		void DoNotOptimize(const T& value)
+		{
+			g_Sink = *reinterpret_cast<const volatile unsigned char*>(&value);
+		}
+
+		// Prints a time measured elsewhere in the same format as Run
+		inline Result Report(const std::string& name, double nanoseconds, size_t items)
+		{
+			const Result result{ name, nanoseconds / double(std::max(items, size_t(1))), items };
+			std::printf("%-48s %10.2f ns/item\n", result.name.c_str(), result.nanosecondsPerItem);
+
+			return result;
+		}
+
+		// Runs function once to warm the caches, then keeps the fastest of the timed runs
+		// function returns how many items it processed, the result is the time per item
+		template<typename Function>
+		Result Run(const std::string& name, Function&& function, int repetitions = 5)
+		{
+			function();
+
+			double bestNanoseconds{ std::numeric_limits<double>::max() };
+			size_t items{};
+
+			for (int repetition{ 0 }; repetition < repetitions; ++repetition)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				items = function();
+				const auto end = std::chrono::steady_clock::now();
+
+				bestNanoseconds = std::min(bestNanoseconds, std::chrono::duration<double, std::nano>(end - start).count());
+			}
+
+			return Report(name, bestNanoseconds, items);
+		}
+	}
+
+	// Every suite prints its own results
+	// The suites that check their results against a reference return false when one fails
+	namespace Benchmarks
+	{
+		void RunTextureBenchmarks();
+		bool RunSpecularBenchmarks();
+		bool RunObjBenchmarks();
+		void RunMathBenchmarks();
+		bool RunRasterBenchmarks();
+	}
+}
@@ -0,0 +1,38 @@
+//Standard includes
+#include <cstdio>
+
+//Project includes
+#include "Benchmark.h"
+#include "CpuFeatures.h"
+
+using namespace dae;
+
+// Usage: Rasterizer_Benchmarks [--isa=<name>], the kernels are compared up to the given or the detected instruction set
+// Exits with 1 when a result differs from its reference or misses its error bound
+int main(int argc, char* argv[])
+{
+	std::printf("Kernels: %s\n\n", CpuFeatures::GetName(CpuFeatures::SelectInstructionSet(argc, argv)));
+
+	std::printf("Math\n");
+	Benchmarks::RunMathBenchmarks();
+
+	std::printf("\nTexture sampling\n");
+	Benchmarks::RunTextureBenchmarks();
+
+	std::printf("\nSpecular exponentiation\n");
+	bool isPassed = Benchmarks::RunSpecularBenchmarks();
+
+	std::printf("\nOBJ loading\n");
+	isPassed = Benchmarks::RunObjBenchmarks() && isPassed;
+
+	std::printf("\nRasterization\n");
+	isPassed = Benchmarks::RunRasterBenchmarks() && isPassed;
+
+	if (!isPassed)
+	{
+		std::printf("\nFAILED, see DIFFERS or EXCEEDED above\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "Camera.h"
+#include "CameraPath.h"
+
+namespace dae
+{
+	namespace Benchmark
+	{
+		// Size of the frames the raster benchmarks render
+		constexpr int SCREEN_WIDTH{ 640 };
+		constexpr int SCREEN_HEIGHT{ 480 };
+
+		// The matrices of the first frame of the benchmark camera path, so the inputs are what the renderer sees
+		struct SceneMatrices
+		{
+			CameraKeyframe pose{};
+			Matrix world{};
+			Matrix viewProjection{};
+			Matrix worldViewProjection{};
+			Vector3 cameraOrigin{};
+		};
+
+		inline SceneMatrices CreateSceneMatrices()
+		{
+			const CameraKeyframe pose = CameraPath::CreateDefault().Evaluate(0.0f);
+
+			Camera camera{};
+			camera.Initialize(45.f, pose.origin);
+			camera.aspectRatio = float(SCREEN_WIDTH) / float(SCREEN_HEIGHT);
+			camera.SetPose(pose.origin, pose.pitch, pose.yaw);
+
+			const Matrix projection = Matrix::CreatePerspectiveFovLH(camera.fov, camera.aspectRatio, camera.near, camera.far);
+			const Matrix world = Matrix::CreateRotationY(pose.meshYaw);
+
+			return SceneMatrices{ pose, world, camera.viewMatrix * projection, world * camera.viewMatrix * projection, camera.origin };
+		}
+	}
+}
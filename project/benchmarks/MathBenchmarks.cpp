@@ -0,0 +1,114 @@
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "BenchmarkScene.h"
+#include "DataTypes.h"
+#include "ObjLoader.h"
+
+namespace dae
+{
+	namespace
+	{
+		// One world matrix per frame of a slowly turning and moving mesh
+		constexpr int MATRIX_COUNT{ 4096 };
+
+		void RunMatrixProducts(const Benchmark::SceneMatrices& scene)
+		{
+			std::vector<Matrix> worldMatrices(MATRIX_COUNT);
+			std::vector<Matrix> results(MATRIX_COUNT);
+
+			for (int index{ 0 }; index < MATRIX_COUNT; ++index)
+			{
+				worldMatrices[index] = Matrix::CreateRotationY(index * 0.001f) * Matrix::CreateTranslation(0.0f, 0.0f, float(index % 16));
+			}
+
+			// Every mesh builds its world view projection matrix once per frame
+			Benchmark::Run("Matrix::operator*, world * view * projection", [&]()
+				{
+					for (int index{ 0 }; index < MATRIX_COUNT; ++index)
+					{
+						results[index] = worldMatrices[index] * scene.viewProjection;
+					}
+
+					Benchmark::DoNotOptimize(results.back());
+					return results.size();
+				});
+		}
+
+		void RunVertexMath(const Benchmark::SceneMatrices& scene, const std::vector<Vertex>& vertices)
+		{
+			std::vector<Vector4> clipPositions(vertices.size());
+			std::vector<Vector3> worldPositions(vertices.size());
+			std::vector<Vector3> worldNormals(vertices.size());
+			std::vector<Vector3> viewDirections(vertices.size());
+
+			Benchmark::Run("Matrix::TransformPoint, to clip space", [&]()
+				{
+					for (size_t index{ 0 }; index < vertices.size(); ++index)
+					{
+						clipPositions[index] = scene.worldViewProjection.TransformPoint(Vector4{ vertices[index].position, 1.0f });
+					}
+
+					Benchmark::DoNotOptimize(clipPositions.back());
+					return vertices.size();
+				});
+
+			Benchmark::Run("Matrix::TransformPoint, to world space", [&]()
+				{
+					for (size_t index{ 0 }; index < vertices.size(); ++index)
+					{
+						worldPositions[index] = scene.world.TransformPoint(vertices[index].position);
+					}
+
+					Benchmark::DoNotOptimize(worldPositions.back());
+					return vertices.size();
+				});
+
+			Benchmark::Run("Matrix::TransformVector, normals", [&]()
+				{
+					for (size_t index{ 0 }; index < vertices.size(); ++index)
+					{
+						worldNormals[index] = scene.world.TransformVector(vertices[index].normal);
+					}
+
+					Benchmark::DoNotOptimize(worldNormals.back());
+					return vertices.size();
+				});
+
+			// The direction from the camera to every vertex, as the vertex stage normalizes it
+			Benchmark::Run("Vector3::Normalized, view directions", [&]()
+				{
+					for (size_t index{ 0 }; index < vertices.size(); ++index)
+					{
+						viewDirections[index] = (worldPositions[index] - scene.cameraOrigin).Normalized();
+					}
+
+					Benchmark::DoNotOptimize(viewDirections.back());
+					return vertices.size();
+				});
+		}
+	}
+
+	namespace Benchmarks
+	{
+		void RunMathBenchmarks()
+		{
+			const Benchmark::SceneMatrices scene = Benchmark::CreateSceneMatrices();
+
+			RunMatrixProducts(scene);
+
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+
+			if (!Utils::LoadOBJ("resources/vehicle.obj", vertices, indices))
+			{
+				std::printf("resources/vehicle.obj not found, skipped\n");
+				return;
+			}
+
+			RunVertexMath(scene, vertices);
+		}
+	}
+}
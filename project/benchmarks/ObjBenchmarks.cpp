@@ -0,0 +1,145 @@
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "Utils.h"
+
+namespace dae
+{
+	namespace
+	{
+		// Enough to make startup hurt with the stream based parser
+		constexpr uint32_t SYNTHETIC_TRIANGLE_COUNT{ 10'000'000 };
+
+		// A square grid of quads split in two, every grid point has its own position, uv and normal line
+		// Written once next to the executable and reused on later runs
+		std::string CreateSyntheticObj(uint32_t triangleCount)
+		{
+			const std::string filename = "synthetic_" + std::to_string(triangleCount) + ".obj";
+
+			if (std::ifstream{ filename })
+				return filename;
+
+			std::printf("writing %s\n", filename.c_str());
+
+			uint32_t quadsPerSide{ 1 };
+			while (2ull * (quadsPerSide + 1) * (quadsPerSide + 1) <= triangleCount) ++quadsPerSide;
+
+			const uint32_t pointsPerSide = quadsPerSide + 1;
+
+			std::FILE* pFile = std::fopen(filename.c_str(), "wb");
+
+			if (!pFile)
+				return {};
+
+			for (uint32_t y{ 0 }; y < pointsPerSide; ++y)
+			{
+				for (uint32_t x{ 0 }; x < pointsPerSide; ++x)
+				{
+					const float u = float(x) / quadsPerSide;
+					const float v = float(y) / quadsPerSide;
+
+					std::fprintf(pFile, "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0.000000 1.000000 0.000000\n", u * 100.0f, 0.0f, v * 100.0f, u, v);
+				}
+			}
+
+			uint32_t trianglesWritten{};
+
+			for (uint32_t y{ 0 }; y < quadsPerSide && trianglesWritten < triangleCount; ++y)
+			{
+				for (uint32_t x{ 0 }; x < quadsPerSide && trianglesWritten < triangleCount; ++x)
+				{
+					const uint32_t corner = y * pointsPerSide + x + 1;
+					const uint32_t right = corner + 1;
+					const uint32_t below = corner + pointsPerSide;
+					const uint32_t diagonal = below + 1;
+
+					std::fprintf(pFile, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", corner, corner, corner, below, below, below, right, right, right);
+					std::fprintf(pFile, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", right, right, right, below, below, below, diagonal, diagonal, diagonal);
+					trianglesWritten += 2;
+				}
+			}
+
+			std::fclose(pFile);
+			return filename;
+		}
+
+		bool AreEqual(const std::vector<Vertex>& firstVertices, const std::vector<uint32_t>& firstIndices, const std::vector<Vertex>& secondVertices, const std::vector<uint32_t>& secondIndices)
+		{
+			return firstVertices.size() == secondVertices.size() && firstIndices == secondIndices
+				&& std::memcmp(firstVertices.data(), secondVertices.data(), firstVertices.size() * sizeof(Vertex)) == 0;
+		}
+
+		// Times the stream parser against the mapped loader on one and on all threads and against the mesh cache, items are triangles
+		// Returns false when a loader builds another mesh than the stream parser
+		bool RunLoaders(const std::string& filename, int repetitions)
+		{
+			std::vector<Vertex> referenceVertices{};
+			std::vector<uint32_t> referenceIndices{};
+
+			if (!Utils::ParseOBJ(filename, referenceVertices, referenceIndices))
+			{
+				std::printf("%s not found, skipped\n", filename.c_str());
+				return true;
+			}
+
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			bool isEverySame{ true };
+
+			const Benchmark::Result parse = Benchmark::Run(filename + ", ParseOBJ", [&]()
+				{
+					Utils::ParseOBJ(filename, vertices, indices);
+					return indices.size() / 3;
+				}, repetitions);
+
+			for (const bool isMultithreaded : { false, true })
+			{
+				const Benchmark::Result load = Benchmark::Run(filename + (isMultithreaded ? ", LoadOBJ all threads" : ", LoadOBJ one thread"), [&]()
+					{
+						Utils::LoadOBJ(filename, vertices, indices, true, nullptr, isMultithreaded);
+						return indices.size() / 3;
+					}, repetitions);
+
+				const bool isSame = AreEqual(vertices, indices, referenceVertices, referenceIndices);
+				std::printf("%48s %10.2fx %s\n", "speedup", parse.nanosecondsPerItem / load.nanosecondsPerItem, isSame ? "same mesh" : "MESH DIFFERS");
+				isEverySame = isEverySame && isSame;
+			}
+
+			// The warm up run writes the cache if it is not there yet, the timed runs read it back
+			const Benchmark::Result cached = Benchmark::Run(filename + ", LoadCachedOBJ", [&]()
+				{
+					Utils::LoadCachedOBJ(filename, vertices, indices);
+					return indices.size() / 3;
+				}, repetitions);
+
+			const bool isSame = AreEqual(vertices, indices, referenceVertices, referenceIndices);
+			std::printf("%48s %10.2fx %s\n", "speedup", parse.nanosecondsPerItem / cached.nanosecondsPerItem, isSame ? "same mesh" : "MESH DIFFERS");
+
+			return isEverySame && isSame;
+		}
+	}
+
+	namespace Benchmarks
+	{
+		bool RunObjBenchmarks()
+		{
+			const bool isVehicleSame = RunLoaders("resources/vehicle.obj", 5);
+
+			const std::string syntheticFilename = CreateSyntheticObj(SYNTHETIC_TRIANGLE_COUNT);
+
+			if (syntheticFilename.empty())
+			{
+				std::printf("could not write the synthetic OBJ, skipped\n");
+				return isVehicleSame;
+			}
+
+			return RunLoaders(syntheticFilename, 1) && isVehicleSame;
+		}
+	}
+}
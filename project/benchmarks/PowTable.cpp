@@ -0,0 +1,55 @@
+#include "PowTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dae
+{
+	PowTable::PowTable(float maxExponent, float maxError)
+	{
+		// Half of maxError goes to each table, interpolating f with a step h is off by at most h^2 / 8 * max|f''|
+		// For log2(1 + m) that is h^2 / (8 * ln(2)), which the result picks up times ln(2) * exponent * pow(base, exponent)
+		m_Log2Bits = CalculateIndexBits(0.125f * std::max(maxExponent, 1.0f), 0.5f * maxError);
+		m_Exp2Bits = CalculateIndexBits(0.125f * 2.0f * std::log(2.0f) * std::log(2.0f), 0.5f * maxError);
+
+		// One extra entry at the end, so the last step still has a neighbour to interpolate towards
+		const uint32_t log2Size = 1u << m_Log2Bits;
+		const uint32_t exp2Size = 1u << m_Exp2Bits;
+
+		m_Log2Table.resize(log2Size + 1);
+		m_Exp2Table.resize(exp2Size + 1);
+
+		for (uint32_t index{ 0 }; index <= log2Size; ++index)
+		{
+			m_Log2Table[index] = float(std::log2(1.0 + double(index) / log2Size));
+		}
+
+		for (uint32_t index{ 0 }; index <= exp2Size; ++index)
+		{
+			m_Exp2Table[index] = float(std::exp2(double(index) / exp2Size));
+		}
+	}
+
+	size_t PowTable::GetLog2TableSize() const
+	{
+		return m_Log2Table.size();
+	}
+
+	size_t PowTable::GetExp2TableSize() const
+	{
+		return m_Exp2Table.size();
+	}
+
+	uint32_t PowTable::CalculateIndexBits(float errorConstant, float maxError)
+	{
+		// Past 16 bits the rounding of the floats themselves dominates
+		uint32_t bits{ 1 };
+
+		while (bits < 16 && errorConstant * std::ldexp(1.0f, -2 * int(bits)) > maxError)
+		{
+			++bits;
+		}
+
+		return bits;
+	}
+}
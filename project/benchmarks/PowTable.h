@@ -0,0 +1,71 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+namespace dae
+{
+	// Approximates pow(base, exponent) as exp2(exponent * log2(base)), with both sides read from a small table
+	// Meant for the specular term: base in [0, 1] and exponent in [0, maxExponent]
+	// The tables are sized so the result never deviates more than maxError from std::pow over that domain
+	// Kept as the baseline PowPolynomial is measured against, PixelShading with it ran within noise of std::pow
+	class PowTable
+	{
+	public:
+		PowTable() = default;
+		PowTable(float maxExponent, float maxError);
+
+		float Pow(float base, float exponent) const;
+
+		size_t GetLog2TableSize() const;
+		size_t GetExp2TableSize() const;
+
+	private:
+		// log2 of the mantissa 1 + m, linearly interpolated on the top bits of m
+		std::vector<float> m_Log2Table{};
+		uint32_t m_Log2Bits{};
+
+		// exp2 of the fraction of the power, the integer part goes straight into the float exponent
+		std::vector<float> m_Exp2Table{};
+		uint32_t m_Exp2Bits{};
+
+		// Smallest number of index bits whose interpolation error stays within maxError
+		// Linear interpolation with a step of 2^-bits is off by at most errorConstant * 4^-bits
+		static uint32_t CalculateIndexBits(float errorConstant, float maxError);
+
+		// Looks up a 23 bit fraction, the top bits pick the entry and the rest is the factor towards the next one
+		// The rest is turned into a float by putting it in the mantissa of one, which keeps conversions off the critical path
+		static float Interpolate(const std::vector<float>& table, uint32_t indexBits, uint32_t fraction);
+	};
+
+	inline float PowTable::Interpolate(const std::vector<float>& table, uint32_t indexBits, uint32_t fraction)
+	{
+		const uint32_t index = fraction >> (23 - indexBits);
+		const float factor = std::bit_cast<float>(((fraction << indexBits) & 0x7fffff) | 0x3f800000) - 1.0f;
+
+		return table[index] + (table[index + 1] - table[index]) * factor;
+	}
+
+	inline float PowTable::Pow(float base, float exponent) const
+	{
+		// Zero has no logarithm, like std::pow anything to the power zero is one
+		if (!(base >= FLT_MIN))
+		{
+			return exponent == 0.0f ? 1.0f : 0.0f;
+		}
+
+		const uint32_t baseBits = std::bit_cast<uint32_t>(base);
+		const float log2 = float(int(baseBits >> 23) - 127) + Interpolate(m_Log2Table, m_Log2Bits, baseBits & 0x7fffff);
+
+		// Below the smallest normal float std::pow is not far from zero either
+		const float power = std::max(exponent * log2, -126.0f);
+
+		// As a fixed point number the fraction is the low 23 bits, and the shift floors the integer part
+		const int fixedPower = int(power * float(1 << 23));
+		const int integer = fixedPower >> 23;
+
+		return Interpolate(m_Exp2Table, m_Exp2Bits, uint32_t(fixedPower) & 0x7fffff) * std::bit_cast<float>(uint32_t(integer + 127) << 23);
+	}
+}
@@ -0,0 +1,286 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BenchmarkScene.h"
+#include "CpuFeatures.h"
+#include "DataTypes.h"
+#include "ObjLoader.h"
+#include "RasterKernels.h"
+#include "Renderer.h"
+
+namespace dae
+{
+	namespace
+	{
+		// One span of a triangle, as the raster loop hands it to the coverage kernel
+		struct SpanInput
+		{
+			uint32_t setupIndex{};
+			float spanCross[3]{};
+			uint32_t laneMask{};
+		};
+
+		VertexTransformSetup CreateTransformSetup(const Benchmark::SceneMatrices& scene)
+		{
+			VertexTransformSetup setup{};
+
+			for (int row{ 0 }; row < 4; ++row)
+			{
+				for (int column{ 0 }; column < 4; ++column)
+				{
+					setup.worldViewProjection[row * 4 + column] = scene.worldViewProjection[row][column];
+					setup.world[row * 4 + column] = scene.world[row][column];
+				}
+			}
+
+			setup.cameraOrigin[0] = scene.cameraOrigin.x;
+			setup.cameraOrigin[1] = scene.cameraOrigin.y;
+			setup.cameraOrigin[2] = scene.cameraOrigin.z;
+			setup.width = float(Benchmark::SCREEN_WIDTH);
+			setup.height = float(Benchmark::SCREEN_HEIGHT);
+
+			return setup;
+		}
+
+		// Cuts the front facing triangles in front of the camera into spans the same way RenderTriangle does, without the depth blocks
+		void CreateSpans(const TransformedVertexBuffer& transformed, const std::vector<uint32_t>& indices, std::vector<EdgeSetup>& setups, std::vector<SpanInput>& spans)
+		{
+			for (size_t index{ 0 }; index + 2 < indices.size(); index += 3)
+			{
+				const Vertex_Out firstVertex = transformed.GetVertex(indices[index]);
+				const Vertex_Out secondVertex = transformed.GetVertex(indices[index + 1]);
+				const Vertex_Out thirdVertex = transformed.GetVertex(indices[index + 2]);
+
+				if (firstVertex.position.w <= 0.0f || secondVertex.position.w <= 0.0f || thirdVertex.position.w <= 0.0f)
+					continue;
+
+				const Vector2 V0{ firstVertex.position.x, firstVertex.position.y };
+				const Vector2 V1{ secondVertex.position.x, secondVertex.position.y };
+				const Vector2 V2{ thirdVertex.position.x, thirdVertex.position.y };
+
+				const float totalArea = Vector2::Cross(V1 - V0, V2 - V0);
+
+				if (totalArea <= 0.0f)
+					continue;
+
+				const int minX = int(std::clamp(std::min({ V0.x, V1.x, V2.x }), 0.0f, float(Benchmark::SCREEN_WIDTH - 1)));
+				const int minY = int(std::clamp(std::min({ V0.y, V1.y, V2.y }), 0.0f, float(Benchmark::SCREEN_HEIGHT - 1)));
+				const int maxX = int(std::clamp(std::ceil(std::max({ V0.x, V1.x, V2.x })), 0.0f, float(Benchmark::SCREEN_WIDTH - 1)));
+				const int maxY = int(std::clamp(std::ceil(std::max({ V0.y, V1.y, V2.y })), 0.0f, float(Benchmark::SCREEN_HEIGHT - 1)));
+
+				if (minX >= maxX || minY >= maxY)
+					continue;
+
+				const Vector2 edgeV0 = V2 - V1;
+				const Vector2 edgeV1 = V0 - V2;
+				const Vector2 edgeV2 = V1 - V0;
+
+				const uint32_t setupIndex = uint32_t(setups.size());
+				setups.push_back(EdgeSetup
+					{
+						{ -edgeV0.y, -edgeV1.y, -edgeV2.y },
+						1 / totalArea,
+						{ firstVertex.position.z, secondVertex.position.z, thirdVertex.position.z }
+					});
+
+				const int spanMinX = minX - minX % RasterKernels::SPAN_WIDTH;
+
+				for (int spanX{ spanMinX }; spanX < maxX; spanX += RasterKernels::SPAN_WIDTH)
+				{
+					const int firstLane = std::max(minX - spanX, 0);
+					const int lastLane = std::min(maxX - spanX, RasterKernels::SPAN_WIDTH);
+					const uint32_t laneMask = ((1u << lastLane) - 1) & ~((1u << firstLane) - 1);
+
+					for (int py{ minY }; py < maxY; ++py)
+					{
+						const Vector2 pixel{ spanX + 0.5f, py + 0.5f };
+
+						spans.push_back(SpanInput
+							{
+								setupIndex,
+								{ Vector2::Cross(edgeV0, pixel - V1), Vector2::Cross(edgeV1, pixel - V2), Vector2::Cross(edgeV2, pixel - V0) },
+								laneMask
+							});
+					}
+				}
+			}
+		}
+
+		// Every vertex kernel this machine can run on the vehicle, items are vertices
+		// Returns false when a kernel puts a vertex somewhere else than the scalar one
+		bool RunVertexKernels(const VertexTransformSetup& setup, const VertexBuffer& vertexBuffer, TransformedVertexBuffer& transformed)
+		{
+			transformed.Resize(vertexBuffer.Size());
+
+			TransformedVertexBuffer reference{};
+			reference.Resize(vertexBuffer.Size());
+			RasterKernels::TransformVerticesScalar(setup, vertexBuffer.GetStreams(), reference.GetStreams(), 0, vertexBuffer.Size());
+
+			double scalarNanoseconds{};
+			bool isEverySame{ true };
+
+			for (int instructionSet{ 0 }; instructionSet <= int(CpuFeatures::GetInstructionSet()); ++instructionSet)
+			{
+				const RasterKernels::KernelTable kernels = RasterKernels::GetKernelTable(InstructionSet(instructionSet));
+				const std::string name = std::string("TransformVertices ") + CpuFeatures::GetName(InstructionSet(instructionSet));
+
+				const Benchmark::Result result = Benchmark::Run(name, [&]()
+					{
+						kernels.transformVertices(setup, vertexBuffer.GetStreams(), transformed.GetStreams(), 0, vertexBuffer.Size());
+						return vertexBuffer.Size();
+					});
+
+				if (instructionSet == 0)
+				{
+					scalarNanoseconds = result.nanosecondsPerItem;
+					continue;
+				}
+
+				// Only the raster positions have to match exactly, they decide coverage
+				bool isSame{ true };
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					isSame = isSame && std::memcmp(transformed.raster[axis].data(), reference.raster[axis].data(), vertexBuffer.Size() * sizeof(float)) == 0;
+				}
+
+				std::printf("%48s %10.2fx %s\n", "speedup", scalarNanoseconds / result.nanosecondsPerItem, isSame ? "same raster positions" : "RASTER POSITIONS DIFFER");
+				isEverySame = isEverySame && isSame;
+			}
+
+			return isEverySame;
+		}
+
+		// Every coverage kernel this machine can run on the spans of the vehicle, against an empty depth buffer, items are spans
+		// Returns false when a kernel covers other pixels than the scalar one
+		bool RunCoverageKernels(const std::vector<EdgeSetup>& setups, const std::vector<SpanInput>& spans)
+		{
+			float depth[RasterKernels::SPAN_WIDTH];
+			std::fill_n(depth, RasterKernels::SPAN_WIDTH, FLT_MAX);
+
+			std::vector<uint32_t> referenceMasks(spans.size());
+			std::vector<uint32_t> masks(spans.size());
+			PixelSpan span{};
+
+			for (size_t index{ 0 }; index < spans.size(); ++index)
+			{
+				referenceMasks[index] = RasterKernels::CoverageSpanScalar(setups[spans[index].setupIndex], spans[index].spanCross, depth, spans[index].laneMask, span);
+			}
+
+			double scalarNanoseconds{};
+			bool isEverySame{ true };
+
+			for (int instructionSet{ 0 }; instructionSet <= int(CpuFeatures::GetInstructionSet()); ++instructionSet)
+			{
+				const RasterKernels::KernelTable kernels = RasterKernels::GetKernelTable(InstructionSet(instructionSet));
+				const std::string name = std::string("CoverageSpan ") + CpuFeatures::GetName(InstructionSet(instructionSet));
+
+				const Benchmark::Result result = Benchmark::Run(name, [&]()
+					{
+						for (size_t index{ 0 }; index < spans.size(); ++index)
+						{
+							masks[index] = kernels.coverageSpan(setups[spans[index].setupIndex], spans[index].spanCross, depth, spans[index].laneMask, span);
+						}
+
+						Benchmark::DoNotOptimize(span);
+						return spans.size();
+					});
+
+				if (instructionSet == 0)
+				{
+					scalarNanoseconds = result.nanosecondsPerItem;
+					continue;
+				}
+
+				std::printf("%48s %10.2fx %s\n", "speedup", scalarNanoseconds / result.nanosecondsPerItem, masks == referenceMasks ? "same coverage" : "COVERAGE DIFFERS");
+				isEverySame = isEverySame && masks == referenceMasks;
+			}
+
+			return isEverySame;
+		}
+
+		// The raster stage of single threaded frames, one call of RenderTriangle for every assembled triangle
+		// Only the raster stage is timed, items are the triangles handed to it
+		void RunRenderTriangle(Renderer& renderer, const std::string& name, int repetitions = 5)
+		{
+			renderer.Render();
+
+			double bestNanoseconds{ DBL_MAX };
+
+			for (int repetition{ 0 }; repetition < repetitions; ++repetition)
+			{
+				renderer.Render();
+				bestNanoseconds = std::min(bestNanoseconds, renderer.GetStageTimings().raster * 1e6);
+			}
+
+			Benchmark::Report(name, bestNanoseconds, renderer.GetStatistics().assembledTriangles);
+		}
+
+		void RunRenderTriangles(const Benchmark::SceneMatrices& scene)
+		{
+			Renderer renderer{ Benchmark::SCREEN_WIDTH, Benchmark::SCREEN_HEIGHT };
+			renderer.SetPose(scene.pose);
+			renderer.ToggleMultithreading();
+
+			// Starts in combined, the toggle goes through observed area, diffuse and specular back to it
+			const char* modeNames[]{ "observed area", "diffuse", "specular", "combined" };
+
+			for (const char* pModeName : modeNames)
+			{
+				renderer.ToggleShadowMode();
+				RunRenderTriangle(renderer, std::string("RenderTriangle ") + pModeName);
+			}
+
+			renderer.ToggleSimdRasterization();
+			RunRenderTriangle(renderer, "RenderTriangle combined, scalar coverage");
+			renderer.ToggleSimdRasterization();
+
+			renderer.ToggleVisibilityBuffer();
+			RunRenderTriangle(renderer, "RenderTriangle combined, visibility buffer");
+			renderer.ToggleVisibilityBuffer();
+
+			renderer.ToggleDepthBuffer();
+			RunRenderTriangle(renderer, "RenderTriangle depth view");
+			renderer.ToggleDepthBuffer();
+		}
+	}
+
+	namespace Benchmarks
+	{
+		bool RunRasterBenchmarks()
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+
+			if (!Utils::LoadOBJ("resources/vehicle.obj", vertices, indices))
+			{
+				std::printf("resources/vehicle.obj not found, skipped\n");
+				return true;
+			}
+
+			const Benchmark::SceneMatrices scene = Benchmark::CreateSceneMatrices();
+
+			VertexBuffer vertexBuffer{};
+			vertexBuffer.Assign(vertices);
+
+			TransformedVertexBuffer transformed{};
+			const bool isVertexSame = RunVertexKernels(CreateTransformSetup(scene), vertexBuffer, transformed);
+
+			std::vector<EdgeSetup> setups{};
+			std::vector<SpanInput> spans{};
+			CreateSpans(transformed, indices, setups, spans);
+			const bool isCoverageSame = RunCoverageKernels(setups, spans);
+
+			RunRenderTriangles(scene);
+
+			return isVertexSame && isCoverageSame;
+		}
+	}
+}
@@ -0,0 +1,196 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "PowPolynomial.h"
+#include "PowTable.h"
+
+namespace dae
+{
+	namespace
+	{
+		constexpr size_t SAMPLE_COUNT{ 1 << 20 };
+
+		// Shininess of the vehicle, the gloss map scales it down to zero
+		constexpr float MAX_EXPONENT{ 25.0f };
+
+		// Bases and exponents in separate arrays, so PowPolynomial can load a span of either at once
+		struct Inputs
+		{
+			std::vector<float> bases{};
+			std::vector<float> exponents{};
+		};
+
+		Inputs CreateRandomInputs()
+		{
+			Inputs inputs{};
+			uint32_t state{ 12345 };
+
+			const auto nextRandom = [&state]()
+				{
+					state = state * 1664525u + 1013904223u;
+					return float(state >> 8) / float(1 << 24);
+				};
+
+			for (size_t index{ 0 }; index < SAMPLE_COUNT; ++index)
+			{
+				inputs.bases.push_back(nextRandom());
+				inputs.exponents.push_back(nextRandom() * MAX_EXPONENT);
+			}
+
+			return inputs;
+		}
+
+		// A regular grid over the whole domain, edges included, followed by the random inputs for the bits in between
+		Inputs CreateAccuracyInputs(const Inputs& randomInputs)
+		{
+			constexpr int BASE_STEPS{ 4096 };
+			constexpr int EXPONENT_STEPS{ 1024 };
+
+			Inputs inputs{};
+
+			for (int baseStep{ 0 }; baseStep <= BASE_STEPS; ++baseStep)
+			{
+				for (int exponentStep{ 0 }; exponentStep <= EXPONENT_STEPS; ++exponentStep)
+				{
+					inputs.bases.push_back(float(baseStep) / BASE_STEPS);
+					inputs.exponents.push_back(MAX_EXPONENT * float(exponentStep) / EXPONENT_STEPS);
+				}
+			}
+
+			inputs.bases.insert(inputs.bases.end(), randomInputs.bases.begin(), randomInputs.bases.end());
+			inputs.exponents.insert(inputs.exponents.end(), randomInputs.exponents.begin(), randomInputs.exponents.end());
+
+			return inputs;
+		}
+
+		void PowTableAll(const PowTable& table, const Inputs& inputs, std::vector<float>& results)
+		{
+			for (size_t index{ 0 }; index < inputs.bases.size(); ++index)
+			{
+				results[index] = table.Pow(inputs.bases[index], inputs.exponents[index]);
+			}
+		}
+
+		// A span at a time, like the renderer calls it, the last one padded with zeros
+		void PowPolynomialAll(const PowPolynomial& polynomial, const Inputs& inputs, std::vector<float>& results)
+		{
+			constexpr size_t LANE_COUNT{ PowPolynomial::LANE_COUNT };
+			const size_t count = inputs.bases.size();
+
+			size_t index{ 0 };
+
+			for (; index + LANE_COUNT <= count; index += LANE_COUNT)
+			{
+				polynomial.Pow(&inputs.bases[index], &inputs.exponents[index], &results[index]);
+			}
+
+			if (index < count)
+			{
+				float bases[LANE_COUNT]{};
+				float exponents[LANE_COUNT]{};
+				float spanResults[LANE_COUNT]{};
+
+				std::copy(inputs.bases.begin() + index, inputs.bases.end(), bases);
+				std::copy(inputs.exponents.begin() + index, inputs.exponents.end(), exponents);
+
+				polynomial.Pow(bases, exponents, spanResults);
+				std::copy_n(spanResults, count - index, results.begin() + index);
+			}
+		}
+
+		// Returns false when an approximation deviates more than maxError somewhere
+		bool ReportAccuracy(const char* pName, const char* pSize, float maxError, const Inputs& inputs, const std::vector<float>& results)
+		{
+			double maxDeviation{};
+			double deviationSum{};
+			size_t worstIndex{};
+
+			for (size_t index{ 0 }; index < results.size(); ++index)
+			{
+				const double deviation = std::abs(double(results[index]) - std::pow(double(inputs.bases[index]), double(inputs.exponents[index])));
+
+				if (deviation > maxDeviation)
+				{
+					maxDeviation = deviation;
+					worstIndex = index;
+				}
+
+				deviationSum += deviation;
+			}
+
+			std::printf("%-13s max error %-9g %-18s max %-12g mean %-12g worst pow(%g, %g) %s\n",
+				pName, maxError, pSize, maxDeviation, deviationSum / double(results.size()),
+				inputs.bases[worstIndex], inputs.exponents[worstIndex], maxDeviation <= maxError ? "ok" : "EXCEEDED");
+
+			return maxDeviation <= maxError;
+		}
+	}
+
+	namespace Benchmarks
+	{
+		bool RunSpecularBenchmarks()
+		{
+			const Inputs inputs = CreateRandomInputs();
+			const Inputs accuracyInputs = CreateAccuracyInputs(inputs);
+
+			std::vector<float> results(accuracyInputs.bases.size());
+			char size[32]{};
+			bool isEveryAccurate{ true };
+
+			for (const float maxError : { 1.0f / 64.0f, 1.0f / 256.0f, PowPolynomial::SPECULAR_MAX_ERROR, 1.0f / 16384.0f })
+			{
+				const PowTable table{ MAX_EXPONENT, maxError };
+				PowTableAll(table, accuracyInputs, results);
+
+				std::snprintf(size, sizeof(size), "tables %zu + %zu", table.GetLog2TableSize(), table.GetExp2TableSize());
+				isEveryAccurate = ReportAccuracy("PowTable", size, maxError, accuracyInputs, results) && isEveryAccurate;
+
+				const PowPolynomial polynomial{ MAX_EXPONENT, maxError };
+				PowPolynomialAll(polynomial, accuracyInputs, results);
+
+				std::snprintf(size, sizeof(size), "degrees %d + %d", polynomial.GetLog2Degree(), polynomial.GetExp2Degree());
+				isEveryAccurate = ReportAccuracy("PowPolynomial", size, maxError, accuracyInputs, results) && isEveryAccurate;
+			}
+
+			results.resize(inputs.bases.size());
+
+			Benchmark::Run("std::pow", [&]()
+				{
+					for (size_t index{ 0 }; index < inputs.bases.size(); ++index)
+					{
+						results[index] = std::pow(inputs.bases[index], inputs.exponents[index]);
+					}
+
+					Benchmark::DoNotOptimize(results.back());
+					return inputs.bases.size();
+				});
+
+			const PowTable table{ MAX_EXPONENT, PowPolynomial::SPECULAR_MAX_ERROR };
+
+			Benchmark::Run("PowTable, max error 1/1024", [&]()
+				{
+					PowTableAll(table, inputs, results);
+
+					Benchmark::DoNotOptimize(results.back());
+					return inputs.bases.size();
+				});
+
+			// The bound the renderer shades with
+			const PowPolynomial polynomial{ MAX_EXPONENT, PowPolynomial::SPECULAR_MAX_ERROR };
+
+			Benchmark::Run("PowPolynomial, max error 1/1024", [&]()
+				{
+					PowPolynomialAll(polynomial, inputs, results);
+
+					Benchmark::DoNotOptimize(results.back());
+					return inputs.bases.size();
+				});
+
+			return isEveryAccurate;
+		}
+	}
+}
@@ -0,0 +1,116 @@
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "Texture.h"
+#include "Vector2.h"
+
+namespace dae
+{
+	namespace
+	{
+		constexpr size_t SAMPLE_COUNT{ 1 << 20 };
+
+		// Side of the vehicle textures
+		constexpr float TEXTURE_SIZE{ 1024.0f };
+
+		// Paths through uv space, built up front so only the sampling is timed
+		std::vector<Vector2> CreateRandomWalk()
+		{
+			std::vector<Vector2> uvs(SAMPLE_COUNT);
+			uint32_t state{ 12345 };
+
+			const auto nextRandom = [&state]()
+				{
+					state = state * 1664525u + 1013904223u;
+					return float(state >> 8) / float(1 << 24);
+				};
+
+			for (Vector2& uv : uvs)
+			{
+				uv.x = nextRandom();
+				uv.y = nextRandom();
+			}
+
+			return uvs;
+		}
+
+		// Steps one texel at a time along a unit direction, every next line starts one texel further to its side
+		std::vector<Vector2> CreateLineWalk(float directionX, float directionY)
+		{
+			std::vector<Vector2> uvs(SAMPLE_COUNT);
+
+			const size_t lineLength{ size_t(TEXTURE_SIZE) };
+
+			for (size_t index{ 0 }; index < SAMPLE_COUNT; ++index)
+			{
+				const float line = float(index / lineLength);
+				const float step = float(index % lineLength);
+
+				uvs[index].x = (step * directionX - line * directionY + 0.5f) / TEXTURE_SIZE;
+				uvs[index].y = (step * directionY + line * directionX + 0.5f) / TEXTURE_SIZE;
+			}
+
+			return uvs;
+		}
+
+		void RunWalk(const std::string& name, const Texture& texture, const std::vector<Vector2>& uvs, TextureFilter filter)
+		{
+			// Derivatives of a texel per pixel keep every sample on the full size level
+			const Vector2 uvDdx{ 1.0f / TEXTURE_SIZE, 0.0f };
+			const Vector2 uvDdy{ 0.0f, 1.0f / TEXTURE_SIZE };
+
+			Benchmark::Run(name, [&]()
+				{
+					ColorRGB sum{};
+
+					for (const Vector2& uv : uvs)
+					{
+						sum += texture.Sample(uv, uvDdx, uvDdy, filter);
+					}
+
+					Benchmark::DoNotOptimize(sum);
+					return uvs.size();
+				});
+		}
+	}
+
+	namespace Benchmarks
+	{
+		void RunTextureBenchmarks()
+		{
+			const std::unique_ptr<Texture> pLinear = Texture::LoadFromFile("resources/vehicle_diffuse.png", TextureLayout::Linear);
+			const std::unique_ptr<Texture> pTiled = Texture::LoadFromFile("resources/vehicle_diffuse.png", TextureLayout::Tiled);
+
+			if (!pLinear || !pTiled)
+			{
+				std::printf("resources/vehicle_diffuse.png not found, skipped\n");
+				return;
+			}
+
+			const struct
+			{
+				const char* name;
+				std::vector<Vector2> uvs;
+			} walks[]
+			{
+				{ "random", CreateRandomWalk() },
+				{ "horizontal", CreateLineWalk(1.0f, 0.0f) },
+				{ "vertical", CreateLineWalk(0.0f, 1.0f) },
+				{ "diagonal", CreateLineWalk(0.7071f, 0.7071f) }
+			};
+
+			for (const auto& walk : walks)
+			{
+				for (const TextureFilter filter : { TextureFilter::Nearest, TextureFilter::Bilinear })
+				{
+					const std::string suffix = std::string(walk.name) + (filter == TextureFilter::Nearest ? ", nearest" : ", bilinear");
+
+					RunWalk("linear " + suffix, *pLinear, walk.uvs, filter);
+					RunWalk("tiled " + suffix, *pTiled, walk.uvs, filter);
+				}
+			}
+		}
+	}
+}
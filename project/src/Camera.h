@@ -67,6 +67,27 @@ namespace dae
 			viewMatrix = invViewMatrix.Inverse();
 		}
 
+		// Orientation from the total pitch and yaw, forward starts out along z
+		void CalculateOrientation()
+		{
+			const Matrix rotMatrix = Matrix::CreateRotation(totalPitch, totalYaw, 0);
+
+			forward = rotMatrix.TransformVector(Vector3::UnitZ);
+			forward.Normalize();
+
+			CalculateViewMatrix();
+		}
+
+		// Places the camera without input, for playing back a camera path
+		void SetPose(const Vector3& _origin, float pitch, float yaw)
+		{
+			origin = _origin;
+			totalPitch = pitch;
+			totalYaw = yaw;
+
+			CalculateOrientation();
+		}
+
 		void CalculateProjectionMatrix()
 		{
 			projectionMatrix = Matrix::CreatePerspectiveFovLH(fov, aspectRatio, near, far);
@@ -138,13 +159,8 @@ namespace dae
 				totalYaw += rotAngleY;
 			}
 
-			const Matrix rotMatrix = Matrix::CreateRotation(totalPitch, totalYaw, 0);
-
-			forward = rotMatrix.TransformVector(Vector3::UnitZ);
-			forward.Normalize();
-
 			//Update Matrices
-			CalculateViewMatrix();
+			CalculateOrientation();
 		}
 	};
 }
@@ -0,0 +1,135 @@
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace dae
+{
+	CameraPath CameraPath::CreateDefault()
+	{
+		// The mesh turns one radian per second, like with rotation on in the interactive mode
+		CameraPath path{};
+		path.AddKeyframe({ 0.0f, { 0.0f, 5.0f, -64.0f }, 0.0f, 0.0f, 0.0f });
+		path.AddKeyframe({ 4.0f, { 0.0f, 5.0f, -32.0f }, -0.1f, 0.0f, 4.0f });
+		path.AddKeyframe({ 8.0f, { 20.0f, 8.0f, -40.0f }, -0.2f, -0.45f, 8.0f });
+		path.AddKeyframe({ 12.0f, { 0.0f, 5.0f, -64.0f }, 0.0f, 0.0f, 12.0f });
+
+		return path;
+	}
+
+	bool CameraPath::LoadFromFile(const std::string& filename, CameraPath& path)
+	{
+		std::ifstream file{ filename };
+
+		if (!file)
+			return false;
+
+		path.Clear();
+
+		std::string line{};
+
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#')
+				continue;
+
+			std::istringstream lineStream{ line };
+			CameraKeyframe keyframe{};
+
+			if (!(lineStream >> keyframe.time >> keyframe.origin.x >> keyframe.origin.y >> keyframe.origin.z >> keyframe.pitch >> keyframe.yaw >> keyframe.meshYaw))
+				return false;
+
+			if (!path.IsEmpty() && keyframe.time < path.m_Keyframes.back().time)
+				return false;
+
+			path.AddKeyframe(keyframe);
+		}
+
+		return !path.IsEmpty();
+	}
+
+	bool CameraPath::SaveToFile(const std::string& filename) const
+	{
+		std::ofstream file{ filename };
+
+		if (!file)
+			return false;
+
+		// Round trips every float exactly
+		file.precision(9);
+		file << "# time x y z pitch yaw meshYaw\n";
+
+		for (const CameraKeyframe& keyframe : m_Keyframes)
+		{
+			file << keyframe.time << ' ' << keyframe.origin.x << ' ' << keyframe.origin.y << ' ' << keyframe.origin.z << ' '
+				<< keyframe.pitch << ' ' << keyframe.yaw << ' ' << keyframe.meshYaw << '\n';
+		}
+
+		return bool(file);
+	}
+
+	void CameraPath::AddKeyframe(const CameraKeyframe& keyframe)
+	{
+		m_Keyframes.push_back(keyframe);
+	}
+
+	void CameraPath::Clear()
+	{
+		m_Keyframes.clear();
+	}
+
+	bool CameraPath::IsEmpty() const
+	{
+		return m_Keyframes.empty();
+	}
+
+	float CameraPath::GetDuration() const
+	{
+		return m_Keyframes.empty() ? 0.0f : m_Keyframes.back().time - m_Keyframes.front().time;
+	}
+
+	CameraKeyframe CameraPath::Evaluate(float time) const
+	{
+		if (m_Keyframes.empty())
+			return CameraKeyframe{ time };
+
+		const float duration = GetDuration();
+		float pathTime = m_Keyframes.front().time;
+
+		if (duration > 0.0f)
+		{
+			pathTime += std::fmod(std::max(time, 0.0f), duration);
+		}
+
+		// First keyframe past the time, the one before it starts the segment
+		size_t nextIndex{ 1 };
+
+		while (nextIndex < m_Keyframes.size() && m_Keyframes[nextIndex].time <= pathTime)
+		{
+			++nextIndex;
+		}
+
+		if (nextIndex == m_Keyframes.size())
+		{
+			CameraKeyframe keyframe = m_Keyframes.back();
+			keyframe.time = time;
+			return keyframe;
+		}
+
+		const CameraKeyframe& previous = m_Keyframes[nextIndex - 1];
+		const CameraKeyframe& next = m_Keyframes[nextIndex];
+
+		const float factor = (pathTime - previous.time) / (next.time - previous.time);
+
+		return CameraKeyframe
+		{
+			time,
+			previous.origin + (next.origin - previous.origin) * factor,
+			Lerpf(previous.pitch, next.pitch, factor),
+			Lerpf(previous.yaw, next.yaw, factor),
+			Lerpf(previous.meshYaw, next.meshYaw, factor)
+		};
+	}
+}
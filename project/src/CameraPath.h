@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Maths.h"
+
+namespace dae
+{
+	// Where the camera is and how far the mesh has turned at a point in time, in seconds
+	struct CameraKeyframe
+	{
+		float time{};
+		Vector3 origin{};
+		float pitch{};
+		float yaw{};
+		float meshYaw{};
+	};
+
+	// Keyframes played back by time instead of by input, so every run renders the same frames
+	// Stored as text, one "time x y z pitch yaw meshYaw" line per keyframe, lines starting with # are skipped
+	class CameraPath final
+	{
+	public:
+		// Turns the mesh like the interactive mode does, while the camera moves closer, to the side and back
+		static CameraPath CreateDefault();
+		static bool LoadFromFile(const std::string& filename, CameraPath& path);
+		bool SaveToFile(const std::string& filename) const;
+
+		// Keyframes have to be added in order of time
+		void AddKeyframe(const CameraKeyframe& keyframe);
+		void Clear();
+
+		bool IsEmpty() const;
+		float GetDuration() const;
+
+		// Linear in between keyframes, a time past the end wraps around to the start
+		CameraKeyframe Evaluate(float time) const;
+
+	private:
+		std::vector<CameraKeyframe> m_Keyframes{};
+	};
+}
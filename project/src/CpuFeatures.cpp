@@ -0,0 +1,187 @@
+#include "CpuFeatures.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		bool g_IsSelected{ false };
+		InstructionSet g_InstructionSet{ InstructionSet::Scalar };
+
+		void CpuId(int leaf, int subLeaf, uint32_t registers[4])
+		{
+#if defined(_MSC_VER)
+			int values[4];
+			__cpuidex(values, leaf, subLeaf);
+
+			for (int index{ 0 }; index < 4; ++index)
+			{
+				registers[index] = uint32_t(values[index]);
+			}
+#else
+			__cpuid_count(leaf, subLeaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+		}
+
+		// Which register states the OS saves on a context switch
+		uint64_t GetEnabledXStateFeatures()
+		{
+#if defined(_MSC_VER)
+			return _xgetbv(0);
+#else
+			uint32_t eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (uint64_t(edx) << 32) | eax;
+#endif
+		}
+
+		bool TryParseInstructionSet(const char* pName, InstructionSet& instructionSet)
+		{
+			const std::string name{ pName };
+
+			for (const InstructionSet candidate : { InstructionSet::Scalar, InstructionSet::SSE42, InstructionSet::AVX2, InstructionSet::AVX512 })
+			{
+				if (name == CpuFeatures::GetName(candidate))
+				{
+					instructionSet = candidate;
+					return true;
+				}
+			}
+
+			return false;
+		}
+	}
+
+	namespace CpuFeatures
+	{
+		InstructionSet DetectInstructionSet()
+		{
+			uint32_t registers[4]{};
+
+			CpuId(0, 0, registers);
+			const uint32_t highestLeaf = registers[0];
+
+			if (highestLeaf < 1)
+			{
+				return InstructionSet::Scalar;
+			}
+
+			CpuId(1, 0, registers);
+			const bool hasSSE42 = (registers[2] & (1u << 20)) != 0;
+			const bool hasOSXSave = (registers[2] & (1u << 27)) != 0;
+			const bool hasAVX = (registers[2] & (1u << 28)) != 0;
+
+			if (!hasSSE42)
+			{
+				return InstructionSet::Scalar;
+			}
+
+			if (!hasOSXSave || !hasAVX || highestLeaf < 7)
+			{
+				return InstructionSet::SSE42;
+			}
+
+			// XMM and YMM state
+			const uint64_t xStateFeatures = GetEnabledXStateFeatures();
+
+			if ((xStateFeatures & 0x6) != 0x6)
+			{
+				return InstructionSet::SSE42;
+			}
+
+			CpuId(7, 0, registers);
+			const bool hasAVX2 = (registers[1] & (1u << 5)) != 0;
+			const bool hasAVX512F = (registers[1] & (1u << 16)) != 0;
+			const bool hasAVX512VL = (registers[1] & (1u << 31)) != 0;
+
+			if (!hasAVX2)
+			{
+				return InstructionSet::SSE42;
+			}
+
+			// Opmask, upper ZMM and high ZMM state on top of the AVX state
+			if (!hasAVX512F || !hasAVX512VL || (xStateFeatures & 0xE6) != 0xE6)
+			{
+				return InstructionSet::AVX2;
+			}
+
+			return InstructionSet::AVX512;
+		}
+
+		InstructionSet SelectInstructionSet(int argc, char* argv[])
+		{
+			const InstructionSet detected = DetectInstructionSet();
+			InstructionSet requested = detected;
+
+			if (const char* pEnvironment = std::getenv("RASTERIZER_ISA"))
+			{
+				if (!TryParseInstructionSet(pEnvironment, requested))
+				{
+					std::cout << "Unknown instruction set in RASTERIZER_ISA: " << pEnvironment << std::endl;
+				}
+			}
+
+			// The command line wins over the environment
+			const char* pPrefix = "--isa=";
+			const size_t prefixLength = std::strlen(pPrefix);
+
+			for (int index{ 1 }; index < argc; ++index)
+			{
+				if (std::strncmp(argv[index], pPrefix, prefixLength) == 0 && !TryParseInstructionSet(argv[index] + prefixLength, requested))
+				{
+					std::cout << "Unknown instruction set: " << argv[index] + prefixLength << std::endl;
+				}
+			}
+
+			if (requested > detected)
+			{
+				std::cout << GetName(requested) << " is not supported on this machine, using " << GetName(detected) << std::endl;
+				requested = detected;
+			}
+
+			g_InstructionSet = requested;
+			g_IsSelected = true;
+
+			return g_InstructionSet;
+		}
+
+		InstructionSet GetInstructionSet()
+		{
+			if (!g_IsSelected)
+			{
+				g_InstructionSet = DetectInstructionSet();
+				g_IsSelected = true;
+			}
+
+			return g_InstructionSet;
+		}
+
+		const char* GetName(InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+			case InstructionSet::Scalar:
+				return "scalar";
+			case InstructionSet::SSE42:
+				return "sse4.2";
+			case InstructionSet::AVX2:
+				return "avx2";
+			case InstructionSet::AVX512:
+				return "avx512";
+			}
+
+			return "unknown";
+		}
+	}
+}
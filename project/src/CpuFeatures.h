@@ -0,0 +1,26 @@
+#pragma once
+
+namespace dae
+{
+	// Ordered from the least to the most capable, every level implies the ones before it
+	enum class InstructionSet
+	{
+		Scalar,
+		SSE42,
+		AVX2,
+		AVX512
+	};
+
+	namespace CpuFeatures
+	{
+		// Highest instruction set supported by both the CPU and the OS
+		InstructionSet DetectInstructionSet();
+
+		// Picks the instruction set used by the kernels, once at startup
+		// The detected one can be lowered with the RASTERIZER_ISA environment variable or the --isa=<name> argument
+		InstructionSet SelectInstructionSet(int argc, char* argv[]);
+		InstructionSet GetInstructionSet();
+
+		const char* GetName(InstructionSet instructionSet);
+	}
+}
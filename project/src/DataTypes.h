@@ -1,5 +1,6 @@
 #pragma once
 #include "Maths.h"
+#include "VertexBuffer.h"
 #include "vector"
 
 namespace dae
@@ -24,19 +25,45 @@ namespace dae
 		Vector3 viewDirection{};
 	};
 
+	struct Triangle
+	{
+		uint32_t meshIndex{};
+		uint32_t vertexIndices[3]{};
+	};
+
 	enum class PrimitiveTopology
 	{
 		TriangleList,
 		TriangleStrip
 	};
 
+	// Axis aligned box around the vertices of a mesh, in object space
+	struct BoundingBox
+	{
+		Vector3 minimum{};
+		Vector3 maximum{};
+	};
+
+	// Which side of a triangle is thrown away before rasterization, triangles wound clockwise on screen face the camera
+	enum class CullMode
+	{
+		None,
+		Back,
+		Front
+	};
+
 	struct Mesh
 	{
 		std::vector<Vertex> vertices{};
 		std::vector<uint32_t> indices{};
 		PrimitiveTopology primitiveTopology{ PrimitiveTopology::TriangleStrip };
+		CullMode cullMode{ CullMode::Back };
 
-		std::vector<Vertex_Out> vertices_out{};
+		TransformedVertexBuffer vertices_out{};
 		Matrix worldMatrix{};
+
+		// Derived from vertices once they are loaded
+		BoundingBox bounds{};
+		VertexBuffer vertexBuffer{};
 	};
 }
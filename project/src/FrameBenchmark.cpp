@@ -0,0 +1,230 @@
+#include "FrameBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+#include "CpuFeatures.h"
+
+namespace dae
+{
+	namespace
+	{
+		bool StartsWith(const char* pArgument, const char* pPrefix, const char*& pValue)
+		{
+			const size_t prefixLength = std::strlen(pPrefix);
+
+			if (std::strncmp(pArgument, pPrefix, prefixLength) != 0)
+				return false;
+
+			pValue = pArgument + prefixLength;
+			return true;
+		}
+	}
+
+	bool FrameBenchmark::ParseSettings(int argc, char* argv[], BenchmarkSettings& settings)
+	{
+		bool isBenchmark{ false };
+
+		for (int index{ 1 }; index < argc; ++index)
+		{
+			const char* pValue{};
+
+			if (std::strcmp(argv[index], "--benchmark") == 0)
+				isBenchmark = true;
+			else if (StartsWith(argv[index], "--benchmark-frames=", pValue))
+				settings.frameCount = std::max(std::atoi(pValue), 1);
+			else if (StartsWith(argv[index], "--benchmark-warmup=", pValue))
+				settings.warmupFrames = std::max(std::atoi(pValue), 0);
+			else if (StartsWith(argv[index], "--benchmark-timestep=", pValue))
+				settings.timeStep = std::max(float(std::atof(pValue)), 0.0f);
+			else if (StartsWith(argv[index], "--benchmark-report=", pValue))
+				settings.reportName = pValue;
+			else if (StartsWith(argv[index], "--camera-path=", pValue))
+				settings.cameraPathFile = pValue;
+		}
+
+		return isBenchmark;
+	}
+
+	std::unique_ptr<FrameBenchmark> FrameBenchmark::Create(const BenchmarkSettings& settings)
+	{
+		CameraPath path = CameraPath::CreateDefault();
+
+		if (!settings.cameraPathFile.empty() && !CameraPath::LoadFromFile(settings.cameraPathFile, path))
+		{
+			std::cout << "Could not load camera path " << settings.cameraPathFile << std::endl;
+			return nullptr;
+		}
+
+		return std::unique_ptr<FrameBenchmark>(new FrameBenchmark(settings, std::move(path)));
+	}
+
+	FrameBenchmark::FrameBenchmark(const BenchmarkSettings& settings, CameraPath path) :
+		m_Settings(settings),
+		m_Path(std::move(path))
+	{
+		m_Samples.reserve(m_Settings.frameCount);
+	}
+
+	bool FrameBenchmark::IsDone() const
+	{
+		return m_FrameIndex >= m_Settings.warmupFrames + m_Settings.frameCount;
+	}
+
+	void FrameBenchmark::BeginFrame(Renderer& renderer)
+	{
+		renderer.SetPose(m_Path.Evaluate(m_FrameIndex * m_Settings.timeStep));
+
+		m_FrameStart = std::chrono::steady_clock::now();
+	}
+
+	void FrameBenchmark::EndFrame(const Renderer& renderer)
+	{
+		const float frameTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_FrameStart).count();
+
+		if (m_FrameIndex >= m_Settings.warmupFrames)
+		{
+			const Renderer::StageTimings& stages = renderer.GetStageTimings();
+			m_Samples.push_back(FrameSample{ frameTime, stages.clear, stages.geometry, stages.binning, stages.raster, stages.present });
+		}
+
+		++m_FrameIndex;
+	}
+
+	bool FrameBenchmark::WriteReports() const
+	{
+		std::cout << "Benchmark: " << m_Samples.size() << " frames, " << m_Settings.timeStep * 1000.0f << " ms timestep" << std::endl;
+
+		for (size_t metric{ 0 }; metric < METRIC_COUNT; ++metric)
+		{
+			std::vector<float> times = GetTimes(metric);
+			const TimeSummary summary = Summarize(times);
+
+			std::cout << METRIC_NAMES[metric] << " ms: min " << summary.min << ", mean " << summary.mean << ", p50 " << summary.p50
+				<< ", p95 " << summary.p95 << ", p99 " << summary.p99 << ", max " << summary.max << std::endl;
+		}
+
+		const bool isJsonWritten = WriteJson(m_Settings.reportName + ".json");
+		const bool isCsvWritten = WriteCsv(m_Settings.reportName + ".csv");
+
+		if (!isJsonWritten || !isCsvWritten)
+			std::cout << "Could not write the benchmark report " << m_Settings.reportName << std::endl;
+
+		return isJsonWritten && isCsvWritten;
+	}
+
+	FrameBenchmark::TimeSummary FrameBenchmark::Summarize(std::vector<float>& times)
+	{
+		if (times.empty())
+			return TimeSummary{};
+
+		std::sort(times.begin(), times.end());
+
+		const auto percentile = [&times](float fraction)
+			{
+				const size_t rank = size_t(std::ceil(fraction * times.size()));
+				return times[std::max(rank, size_t{ 1 }) - 1];
+			};
+
+		return TimeSummary
+		{
+			times.front(),
+			float(std::accumulate(times.begin(), times.end(), 0.0) / times.size()),
+			percentile(0.50f),
+			percentile(0.95f),
+			percentile(0.99f),
+			times.back()
+		};
+	}
+
+	std::vector<float> FrameBenchmark::GetTimes(size_t metric) const
+	{
+		std::vector<float> times{};
+		times.reserve(m_Samples.size());
+
+		for (const FrameSample& sample : m_Samples)
+		{
+			times.push_back(sample[metric]);
+		}
+
+		return times;
+	}
+
+	bool FrameBenchmark::WriteJson(const std::string& filename) const
+	{
+		std::ofstream file{ filename };
+
+		if (!file)
+			return false;
+
+		// The camera path is the only string that comes from the user
+		std::string cameraPath{};
+
+		for (const char character : m_Settings.cameraPathFile)
+		{
+			if (character == '"' || character == '\\')
+				cameraPath += '\\';
+
+			cameraPath += character;
+		}
+
+		file << "{\n";
+		file << "\t\"kernels\": \"" << CpuFeatures::GetName(CpuFeatures::GetInstructionSet()) << "\",\n";
+		file << "\t\"cameraPath\": \"" << (cameraPath.empty() ? "default" : cameraPath) << "\",\n";
+		file << "\t\"frames\": " << m_Samples.size() << ",\n";
+		file << "\t\"warmupFrames\": " << m_Settings.warmupFrames << ",\n";
+		file << "\t\"timeStep\": " << m_Settings.timeStep << ",\n";
+		file << "\t\"milliseconds\": {\n";
+
+		for (size_t metric{ 0 }; metric < METRIC_COUNT; ++metric)
+		{
+			std::vector<float> times = GetTimes(metric);
+			const TimeSummary summary = Summarize(times);
+
+			file << "\t\t\"" << METRIC_NAMES[metric] << "\": { \"min\": " << summary.min << ", \"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+				<< ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << " }"
+				<< (metric + 1 < METRIC_COUNT ? ",\n" : "\n");
+		}
+
+		file << "\t}\n";
+		file << "}\n";
+
+		return bool(file);
+	}
+
+	bool FrameBenchmark::WriteCsv(const std::string& filename) const
+	{
+		std::ofstream file{ filename };
+
+		if (!file)
+			return false;
+
+		file << "frame";
+
+		for (const char* pName : METRIC_NAMES)
+		{
+			file << ',' << pName << "_ms";
+		}
+
+		file << '\n';
+
+		for (size_t index{ 0 }; index < m_Samples.size(); ++index)
+		{
+			file << m_Settings.warmupFrames + index;
+
+			for (const float time : m_Samples[index])
+			{
+				file << ',' << time;
+			}
+
+			file << '\n';
+		}
+
+		return bool(file);
+	}
+}
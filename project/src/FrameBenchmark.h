@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CameraPath.h"
+#include "Renderer.h"
+
+namespace dae
+{
+	// How a benchmark run is set up, taken from the command line
+	struct BenchmarkSettings
+	{
+		int frameCount{ 600 };
+		// Rendered before measuring so the caches and the thread pool are warm, they still follow the path
+		int warmupFrames{ 30 };
+		// Simulated time between two frames, independent of how long rendering takes
+		float timeStep{ 1.0f / 60.0f };
+		// Recorded camera path, the default one is used when empty
+		std::string cameraPathFile{};
+		// Written as <name>.json with the summary and <name>.csv with every measured frame
+		std::string reportName{ "benchmark" };
+	};
+
+	// Renders a fixed number of frames along a camera path with a fixed timestep, so every run renders the same images
+	// Reports min, mean, percentiles and max of the frame time and of every stage of the renderer
+	class FrameBenchmark final
+	{
+	public:
+		// True when --benchmark is passed, along with --benchmark-frames=, --benchmark-warmup=, --benchmark-timestep=,
+		// --benchmark-report= and --camera-path= to change the settings
+		static bool ParseSettings(int argc, char* argv[], BenchmarkSettings& settings);
+
+		// Null when the camera path can not be loaded
+		static std::unique_ptr<FrameBenchmark> Create(const BenchmarkSettings& settings);
+
+		bool IsDone() const;
+
+		// Poses the renderer for the next frame, the frame time is measured from here to EndFrame
+		void BeginFrame(Renderer& renderer);
+		void EndFrame(const Renderer& renderer);
+
+		// Prints the summary and writes the JSON and CSV report, false when a file could not be written
+		bool WriteReports() const;
+
+	private:
+		// The whole frame followed by the stages of the renderer, in milliseconds
+		static constexpr size_t METRIC_COUNT{ 6 };
+		static constexpr const char* METRIC_NAMES[METRIC_COUNT]{ "frame", "clear", "geometry", "binning", "raster", "present" };
+
+		using FrameSample = std::array<float, METRIC_COUNT>;
+
+		struct TimeSummary
+		{
+			float min{};
+			float mean{};
+			float p50{};
+			float p95{};
+			float p99{};
+			float max{};
+		};
+
+		FrameBenchmark(const BenchmarkSettings& settings, CameraPath path);
+
+		BenchmarkSettings m_Settings{};
+		CameraPath m_Path{};
+
+		int m_FrameIndex{};
+		std::chrono::steady_clock::time_point m_FrameStart{};
+		std::vector<FrameSample> m_Samples{};
+
+		// Nearest rank percentiles, the times are sorted in place
+		static TimeSummary Summarize(std::vector<float>& times);
+		std::vector<float> GetTimes(size_t metric) const;
+
+		bool WriteJson(const std::string& filename) const;
+		bool WriteCsv(const std::string& filename) const;
+	};
+}
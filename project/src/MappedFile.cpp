@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dae
+{
+	MappedFile::MappedFile(const std::string& filename)
+	{
+#ifdef _WIN32
+		const HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+
+		m_pFile = file;
+
+		LARGE_INTEGER size{};
+
+		if (!GetFileSizeEx(file, &size))
+			return;
+
+		m_Size = size_t(size.QuadPart);
+
+		// An empty file can not be mapped, but it is still a file
+		if (m_Size == 0)
+		{
+			m_IsOpen = true;
+			return;
+		}
+
+		m_pMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (m_pMapping)
+		{
+			m_pData = static_cast<const char*>(MapViewOfFile(m_pMapping, FILE_MAP_READ, 0, 0, 0));
+		}
+
+		m_IsOpen = m_pData != nullptr;
+#else
+		const int descriptor = open(filename.c_str(), O_RDONLY);
+
+		if (descriptor < 0)
+			return;
+
+		struct stat status{};
+
+		if (fstat(descriptor, &status) == 0)
+		{
+			m_Size = size_t(status.st_size);
+			m_IsOpen = true;
+
+			// An empty file can not be mapped, but it is still a file
+			if (m_Size != 0)
+			{
+				void* pMapping = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+				if (pMapping == MAP_FAILED)
+				{
+					m_IsOpen = false;
+				}
+				else
+				{
+					madvise(pMapping, m_Size, MADV_SEQUENTIAL);
+					m_pData = static_cast<const char*>(pMapping);
+				}
+			}
+		}
+
+		// The mapping keeps its own reference to the file
+		close(descriptor);
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifdef _WIN32
+		if (m_pData) UnmapViewOfFile(m_pData);
+		if (m_pMapping) CloseHandle(m_pMapping);
+		if (m_pFile) CloseHandle(m_pFile);
+#else
+		if (m_pData) munmap(const_cast<char*>(m_pData), m_Size);
+#endif
+	}
+
+	bool MappedFile::IsOpen() const
+	{
+		return m_IsOpen;
+	}
+
+	const char* MappedFile::GetData() const
+	{
+		return m_pData;
+	}
+
+	size_t MappedFile::GetSize() const
+	{
+		return m_Size;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace dae
+{
+	// Read only view of a whole file, unmapped again when it goes out of scope
+	class MappedFile final
+	{
+	public:
+		explicit MappedFile(const std::string& filename);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) noexcept = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) noexcept = delete;
+
+		bool IsOpen() const;
+		const char* GetData() const;
+		size_t GetSize() const;
+
+	private:
+		const char* m_pData{};
+		size_t m_Size{};
+		bool m_IsOpen{};
+
+		// Windows handles of the file and its mapping, unused elsewhere
+		void* m_pFile{};
+		void* m_pMapping{};
+	};
+}
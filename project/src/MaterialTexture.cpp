@@ -0,0 +1,59 @@
+#include "MaterialTexture.h"
+
+namespace dae
+{
+	std::unique_ptr<MaterialTexture> MaterialTexture::Create(const Texture& diffuse, const Texture& normal, const Texture& specular, const Texture& gloss, TextureLayout layout)
+	{
+		const Texture* maps[]{ &diffuse, &normal, &specular, &gloss };
+
+		for (const Texture* pMap : maps)
+		{
+			if (pMap->GetWidth(0) != diffuse.GetWidth(0) || pMap->GetHeight(0) != diffuse.GetHeight(0))
+			{
+				return nullptr;
+			}
+		}
+
+		// Same size, so the maps have the same mip chain as well
+		std::vector<MipChain<Texel, TexelTraits>::Level> mipLevels{};
+
+		for (int level{ 0 }; level < diffuse.GetLevelCount(); ++level)
+		{
+			MipChain<Texel, TexelTraits>::Level mipLevel{ diffuse.GetWidth(level), diffuse.GetHeight(level) };
+			mipLevel.texels.resize(size_t(mipLevel.width) * mipLevel.height);
+
+			for (int y{ 0 }; y < mipLevel.height; ++y)
+			{
+				for (int x{ 0 }; x < mipLevel.width; ++x)
+				{
+					Texel& texel = mipLevel.texels[size_t(y) * mipLevel.width + x];
+
+					texel.diffuseGloss = (diffuse.GetTexel(level, x, y) & 0x00ffffff) | (gloss.GetTexel(level, x, y) << 24);
+					texel.normal = normal.GetTexel(level, x, y);
+					texel.specular = specular.GetTexel(level, x, y);
+				}
+			}
+
+			mipLevels.push_back(std::move(mipLevel));
+		}
+
+		std::unique_ptr<MaterialTexture> pMaterial{ new MaterialTexture() };
+		pMaterial->m_MipChain = MipChain<Texel, TexelTraits>{ std::move(mipLevels), layout };
+
+		return pMaterial;
+	}
+
+	std::unique_ptr<MaterialTexture> MaterialTexture::CreateFlat()
+	{
+		// The normal map stores (0, 0, 1) as (128, 128, 255)
+		const Texel texel{ 0x00ffffff, 0xffff8080, 0xff000000 };
+
+		std::vector<MipChain<Texel, TexelTraits>::Level> mipLevels{};
+		mipLevels.push_back(MipChain<Texel, TexelTraits>::Level{ 1, 1, 0, { texel } });
+
+		std::unique_ptr<MaterialTexture> pMaterial{ new MaterialTexture() };
+		pMaterial->m_MipChain = MipChain<Texel, TexelTraits>{ std::move(mipLevels), TextureLayout::Linear };
+
+		return pMaterial;
+	}
+}
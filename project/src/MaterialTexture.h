@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ColorRGB.h"
+#include "MathHelpers.h"
+#include "MipChain.h"
+#include "Texture.h"
+
+namespace dae
+{
+	// Everything the shading reads at one uv
+	struct MaterialSample
+	{
+		ColorRGB diffuse{};
+		ColorRGB normal{};
+		ColorRGB specular{};
+		float gloss{};
+	};
+
+	// The diffuse, normal, specular and gloss maps of a material interleaved per texel
+	// One fetch brings in every channel the shading needs, instead of four lookups into four separate images
+	class MaterialTexture
+	{
+	public:
+		// The four maps have to be the same size, gloss only keeps its red channel
+		// Returns nullptr when the sizes differ
+		static std::unique_ptr<MaterialTexture> Create(const Texture& diffuse, const Texture& normal, const Texture& specular, const Texture& gloss, TextureLayout layout = TextureLayout::Linear);
+
+		// A single texel: white diffuse, the normal of the surface itself, no specular and no gloss
+		static std::unique_ptr<MaterialTexture> CreateFlat();
+
+		MaterialSample Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, TextureFilter filter) const;
+
+	private:
+		MaterialTexture() = default;
+
+		// 12 bytes, RGBA8 with red in the lowest byte, gloss sits in the alpha byte of the diffuse color
+		struct Texel
+		{
+			uint32_t diffuseGloss{};
+			uint32_t normal{};
+			uint32_t specular{};
+		};
+
+		struct TexelTraits
+		{
+			using Value = MaterialSample;
+
+			static MaterialSample Decode(const Texel& texel)
+			{
+				return MaterialSample
+				{
+					ColorTexelTraits::Decode(texel.diffuseGloss),
+					ColorTexelTraits::Decode(texel.normal),
+					ColorTexelTraits::Decode(texel.specular),
+					BYTE_TO_FLOAT[texel.diffuseGloss >> 24]
+				};
+			}
+
+			static MaterialSample Lerp(const MaterialSample& first, const MaterialSample& second, float factor)
+			{
+				return MaterialSample
+				{
+					ColorRGB::Lerp(first.diffuse, second.diffuse, factor),
+					ColorRGB::Lerp(first.normal, second.normal, factor),
+					ColorRGB::Lerp(first.specular, second.specular, factor),
+					Lerpf(first.gloss, second.gloss, factor)
+				};
+			}
+		};
+
+		MipChain<Texel, TexelTraits> m_MipChain{};
+	};
+
+	inline MaterialSample MaterialTexture::Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, TextureFilter filter) const
+	{
+		return m_MipChain.Sample(uv, uvDdx, uvDdy, filter);
+	}
+}
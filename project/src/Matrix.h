@@ -1,24 +1,32 @@
 #pragma once
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+#include "MathHelpers.h"
 #include "Vector3.h"
 #include "Vector4.h"
 
 namespace dae {
+	// Defined inline, the products work on whole rows in SSE registers
+	// A row of the product is the rows of the right hand side weighted by one row of the left, summed in the same order as the dot products they replace
 	struct Matrix
 	{
 		Matrix() = default;
-		Matrix(
+		constexpr Matrix(
 			const Vector3& xAxis,
 			const Vector3& yAxis,
 			const Vector3& zAxis,
 			const Vector3& t);
 
-		Matrix(
+		constexpr Matrix(
 			const Vector4& xAxis,
 			const Vector4& yAxis,
 			const Vector4& zAxis,
 			const Vector4& t);
 
-		Matrix(const Matrix& m);
+		Matrix(const Matrix& m) = default;
+		Matrix& operator=(const Matrix& m) = default;
 
 		Vector3 TransformVector(const Vector3& v) const;
 		Vector3 TransformVector(float x, float y, float z) const;
@@ -31,10 +39,10 @@ namespace dae {
 		const Matrix& Transpose();
 		const Matrix& Inverse();
 
-		Vector3 GetAxisX() const;
-		Vector3 GetAxisY() const;
-		Vector3 GetAxisZ() const;
-		Vector3 GetTranslation() const;
+		constexpr Vector3 GetAxisX() const;
+		constexpr Vector3 GetAxisY() const;
+		constexpr Vector3 GetAxisZ() const;
+		constexpr Vector3 GetTranslation() const;
 
 		static Matrix CreateTranslation(float x, float y, float z);
 		static Matrix CreateTranslation(const Vector3& t);
@@ -72,5 +80,277 @@ namespace dae {
 		// v1x v1y v1z v1w
 		// v2x v2y v2z v2w
 		// v3x v3y v3z v3w
+
+		// x * row 0 + y * row 1 + z * row 2 + w * row 3
+		__m128 CombineRows(__m128 x, __m128 y, __m128 z, __m128 w) const;
 	};
-}
\ No newline at end of file
+
+	constexpr Matrix::Matrix(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& t) :
+		Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+	{
+	}
+
+	constexpr Matrix::Matrix(const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis, const Vector4& t) :
+		data{ xAxis, yAxis, zAxis, t }
+	{
+	}
+
+	inline __m128 Matrix::CombineRows(__m128 x, __m128 y, __m128 z, __m128 w) const
+	{
+		__m128 result = _mm_mul_ps(x, data[0].ToSimd());
+		result = _mm_add_ps(result, _mm_mul_ps(y, data[1].ToSimd()));
+		result = _mm_add_ps(result, _mm_mul_ps(z, data[2].ToSimd()));
+		return _mm_add_ps(result, _mm_mul_ps(w, data[3].ToSimd()));
+	}
+
+	inline Vector3 Matrix::TransformVector(const Vector3& v) const
+	{
+		return TransformVector(v.x, v.y, v.z);
+	}
+
+	inline Vector3 Matrix::TransformVector(float x, float y, float z) const
+	{
+		__m128 result = _mm_mul_ps(_mm_set1_ps(x), data[0].ToSimd());
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(y), data[1].ToSimd()));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(z), data[2].ToSimd()));
+
+		return Vector4{ result }.GetXYZ();
+	}
+
+	inline Vector3 Matrix::TransformPoint(const Vector3& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z);
+	}
+
+	inline Vector3 Matrix::TransformPoint(float x, float y, float z) const
+	{
+		__m128 result = _mm_mul_ps(_mm_set1_ps(x), data[0].ToSimd());
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(y), data[1].ToSimd()));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(z), data[2].ToSimd()));
+		result = _mm_add_ps(result, data[3].ToSimd());
+
+		return Vector4{ result }.GetXYZ();
+	}
+
+	inline Vector4 Matrix::TransformPoint(const Vector4& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z, p.w);
+	}
+
+	inline Vector4 Matrix::TransformPoint(float x, float y, float z, float w) const
+	{
+		return Vector4{ CombineRows(_mm_set1_ps(x), _mm_set1_ps(y), _mm_set1_ps(z), _mm_set1_ps(w)) };
+	}
+
+	inline const Matrix& Matrix::Transpose()
+	{
+		__m128 row0 = data[0].ToSimd();
+		__m128 row1 = data[1].ToSimd();
+		__m128 row2 = data[2].ToSimd();
+		__m128 row3 = data[3].ToSimd();
+
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+		data[0] = Vector4{ row0 };
+		data[1] = Vector4{ row1 };
+		data[2] = Vector4{ row2 };
+		data[3] = Vector4{ row3 };
+
+		return *this;
+	}
+
+	inline const Matrix& Matrix::Inverse()
+	{
+		//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
+		const Vector3& a = data[0];
+		const Vector3& b = data[1];
+		const Vector3& c = data[2];
+		const Vector3& d = data[3];
+
+		const float x = data[0][3];
+		const float y = data[1][3];
+		const float z = data[2][3];
+		const float w = data[3][3];
+
+		Vector3 s = Vector3::Cross(a, b);
+		Vector3 t = Vector3::Cross(c, d);
+		Vector3 u = a * y - b * x;
+		Vector3 v = c * w - d * z;
+
+		float det = Vector3::Dot(s, v) + Vector3::Dot(t, u);
+		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+		float invDet = 1.f / det;
+
+		s *= invDet; t *= invDet; u *= invDet; v *= invDet;
+
+		Vector3 r0 = Vector3::Cross(b, v) + t * y;
+		Vector3 r1 = Vector3::Cross(v, a) - t * x;
+		Vector3 r2 = Vector3::Cross(d, u) + s * w;
+
+		data[0] = Vector4{ r0.x, r1.x, r2.x, 0.f };
+		data[1] = Vector4{ r0.y, r1.y, r2.y, 0.f };
+		data[2] = Vector4{ r0.z, r1.z, r2.z, 0.f };
+		data[3] = { { -Vector3::Dot(b, t)},{Vector3::Dot(a, t)},{-Vector3::Dot(d, s)},{Vector3::Dot(c, s)} };
+
+		return *this;
+	}
+
+	inline Matrix Matrix::Transpose(const Matrix& m)
+	{
+		Matrix out{ m };
+		out.Transpose();
+
+		return out;
+	}
+
+	inline Matrix Matrix::Inverse(const Matrix& m)
+	{
+		Matrix out{ m };
+		out.Inverse();
+
+		return out;
+	}
+
+	inline Matrix Matrix::CreateLookAtLH([[maybe_unused]] const Vector3& origin, [[maybe_unused]] const Vector3& forward, [[maybe_unused]] const Vector3& up)
+	{
+		//TODO W1
+
+		// no. Just no
+
+		return {};
+	}
+
+	inline Matrix Matrix::CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf)
+	{
+		return Matrix
+		{
+			Vector4{1 / (aspect * fov), 0, 0, 0},
+			Vector4{0, 1 / fov, 0, 0},
+			Vector4{0, 0, zf / (zf - zn), 1},
+			Vector4{0, 0, -(zf * zn) / (zf - zn), 0}
+		};
+	}
+
+	constexpr Vector3 Matrix::GetAxisX() const
+	{
+		return data[0];
+	}
+
+	constexpr Vector3 Matrix::GetAxisY() const
+	{
+		return data[1];
+	}
+
+	constexpr Vector3 Matrix::GetAxisZ() const
+	{
+		return data[2];
+	}
+
+	constexpr Vector3 Matrix::GetTranslation() const
+	{
+		return data[3];
+	}
+
+	inline Matrix Matrix::CreateTranslation(float x, float y, float z)
+	{
+		return CreateTranslation({ x, y, z });
+	}
+
+	inline Matrix Matrix::CreateTranslation(const Vector3& t)
+	{
+		return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+	}
+
+	inline Matrix Matrix::CreateRotationX(float pitch)
+	{
+		return {
+			{1, 0, 0, 0},
+			{0, std::cos(pitch), -std::sin(pitch), 0},
+			{0, std::sin(pitch), std::cos(pitch), 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotationY(float yaw)
+	{
+		return {
+			{std::cos(yaw), 0, -std::sin(yaw), 0},
+			{0, 1, 0, 0},
+			{std::sin(yaw), 0, std::cos(yaw), 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotationZ(float roll)
+	{
+		return {
+			{std::cos(roll), std::sin(roll), 0, 0},
+			{-std::sin(roll), std::cos(roll), 0, 0},
+			{0, 0, 1, 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotation(float pitch, float yaw, float roll)
+	{
+		return CreateRotation({ pitch, yaw, roll });
+	}
+
+	inline Matrix Matrix::CreateRotation(const Vector3& r)
+	{
+		return CreateRotationX(r[0]) * CreateRotationY(r[1]) * CreateRotationZ(r[2]);
+	}
+
+	inline Matrix Matrix::CreateScale(float sx, float sy, float sz)
+	{
+		return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
+	}
+
+	inline Matrix Matrix::CreateScale(const Vector3& s)
+	{
+		return CreateScale(s[0], s[1], s[2]);
+	}
+
+#pragma region Operator Overloads
+	inline Vector4& Matrix::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	inline Vector4 Matrix::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	inline Matrix Matrix::operator*(const Matrix& m) const
+	{
+		Matrix result{};
+
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			const Vector4& row = data[r];
+			result.data[r] = Vector4{ m.CombineRows(_mm_set1_ps(row.x), _mm_set1_ps(row.y), _mm_set1_ps(row.z), _mm_set1_ps(row.w)) };
+		}
+
+		return result;
+	}
+
+	inline const Matrix& Matrix::operator*=(const Matrix& m)
+	{
+		*this = *this * m;
+
+		return *this;
+	}
+
+	inline bool Matrix::operator==(const Matrix& m) const
+	{
+		return data[0] == m.data[0]
+		    && data[1] == m.data[1]
+			&& data[2] == m.data[2]
+			&& data[3] == m.data[3];
+	}
+
+#pragma endregion
+}
@@ -0,0 +1,222 @@
+#include "MeshCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "MappedFile.h"
+#include "ObjLoader.h"
+
+namespace dae
+{
+	namespace
+	{
+		// Bump whenever Vertex or the way a mesh is built from an OBJ changes, every older cache is rebuilt then
+		constexpr uint32_t MESH_CACHE_VERSION{ 1 };
+		constexpr char MESH_CACHE_MAGIC[4]{ 'M', 'E', 'S', 'H' };
+
+		// The blobs start on a cache line, like the buffers they end up in
+		constexpr size_t BLOB_ALIGNMENT{ 64 };
+
+		struct MeshCacheHeader
+		{
+			char magic[4]{};
+			uint32_t version{};
+			uint32_t vertexSize{};
+			uint32_t isFlipped{};
+
+			// The OBJ the cache was built from
+			uint64_t sourceSize{};
+			int64_t sourceWriteTime{};
+			uint64_t sourceHash{};
+
+			uint64_t vertexCount{};
+			uint64_t vertexOffset{};
+			uint64_t indexCount{};
+			uint64_t indexOffset{};
+		};
+
+		// What can be checked without reading the OBJ
+		struct SourceKey
+		{
+			uint64_t size{};
+			int64_t writeTime{};
+		};
+
+		bool GetSourceKey(const std::string& filename, SourceKey& key)
+		{
+			std::error_code error{};
+
+			key.size = std::filesystem::file_size(filename, error);
+
+			if (error)
+				return false;
+
+			key.writeTime = std::filesystem::last_write_time(filename, error).time_since_epoch().count();
+
+			return !error;
+		}
+
+		// FNV-1a over eight bytes at a time, with a shift so the high bits reach the low ones
+		uint64_t HashFile(const std::string& filename)
+		{
+			const MappedFile file{ filename };
+
+			const char* pData = file.GetData();
+			const size_t size = file.GetSize();
+
+			uint64_t hash{ 0xcbf29ce484222325ull };
+			size_t offset{ 0 };
+
+			for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+			{
+				uint64_t word{};
+				std::memcpy(&word, pData + offset, sizeof(uint64_t));
+
+				hash = (hash ^ word) * 0x100000001b3ull;
+				hash ^= hash >> 29;
+			}
+
+			for (; offset < size; ++offset)
+			{
+				hash = (hash ^ uint8_t(pData[offset])) * 0x100000001b3ull;
+			}
+
+			return hash;
+		}
+
+		size_t AlignUp(size_t offset)
+		{
+			return (offset + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT;
+		}
+
+		// Fails on anything that does not match, isWriteTimeOutdated tells a moved or touched OBJ with the same content
+		bool ReadCache(const std::string& cacheFilename, const std::string& filename, const SourceKey& key, bool flipAxisAndWinding,
+			std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool& isWriteTimeOutdated, uint64_t& sourceHash)
+		{
+			const MappedFile cache{ cacheFilename };
+
+			if (!cache.IsOpen() || cache.GetSize() < sizeof(MeshCacheHeader))
+				return false;
+
+			MeshCacheHeader header{};
+			std::memcpy(&header, cache.GetData(), sizeof(MeshCacheHeader));
+
+			if (std::memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0 || header.version != MESH_CACHE_VERSION
+				|| header.vertexSize != sizeof(Vertex) || header.isFlipped != uint32_t(flipAxisAndWinding) || header.sourceSize != key.size)
+				return false;
+
+			// Checkouts and copies change the write time but not the content, only then is the OBJ read to compare hashes
+			isWriteTimeOutdated = header.sourceWriteTime != key.writeTime;
+
+			if (isWriteTimeOutdated && HashFile(filename) != header.sourceHash)
+				return false;
+
+			sourceHash = header.sourceHash;
+
+			// A truncated cache must not be read past its end
+			const size_t size = cache.GetSize();
+
+			if (header.vertexOffset > size || header.vertexCount > (size - header.vertexOffset) / sizeof(Vertex)
+				|| header.indexOffset > size || header.indexCount > (size - header.indexOffset) / sizeof(uint32_t))
+				return false;
+
+			vertices.resize(size_t(header.vertexCount));
+			indices.resize(size_t(header.indexCount));
+
+			std::memcpy(vertices.data(), cache.GetData() + header.vertexOffset, vertices.size() * sizeof(Vertex));
+			std::memcpy(indices.data(), cache.GetData() + header.indexOffset, indices.size() * sizeof(uint32_t));
+
+			return true;
+		}
+
+		// Written to a temporary file that replaces the cache at once, so a cache is never seen half written
+		void WriteCache(const std::string& cacheFilename, const SourceKey& key, uint64_t sourceHash, bool flipAxisAndWinding,
+			const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+		{
+			MeshCacheHeader header{};
+			std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+			header.version = MESH_CACHE_VERSION;
+			header.vertexSize = uint32_t(sizeof(Vertex));
+			header.isFlipped = uint32_t(flipAxisAndWinding);
+			header.sourceSize = key.size;
+			header.sourceWriteTime = key.writeTime;
+			header.sourceHash = sourceHash;
+			header.vertexCount = vertices.size();
+			header.vertexOffset = AlignUp(sizeof(MeshCacheHeader));
+			header.indexCount = indices.size();
+			header.indexOffset = AlignUp(header.vertexOffset + vertices.size() * sizeof(Vertex));
+
+			const std::string temporaryFilename = cacheFilename + ".tmp";
+			const char padding[BLOB_ALIGNMENT]{};
+			bool isWritten{};
+
+			{
+				std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+
+				file.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+				file.write(padding, std::streamsize(header.vertexOffset - sizeof(MeshCacheHeader)));
+				file.write(reinterpret_cast<const char*>(vertices.data()), std::streamsize(vertices.size() * sizeof(Vertex)));
+				file.write(padding, std::streamsize(header.indexOffset - header.vertexOffset - vertices.size() * sizeof(Vertex)));
+				file.write(reinterpret_cast<const char*>(indices.data()), std::streamsize(indices.size() * sizeof(uint32_t)));
+
+				file.close();
+
+				isWritten = bool(file);
+			}
+
+			// Without a cache the next start parses again, nothing worse
+			std::error_code error{};
+
+			if (!isWritten)
+			{
+				std::filesystem::remove(temporaryFilename, error);
+				return;
+			}
+
+			std::filesystem::rename(temporaryFilename, cacheFilename, error);
+
+			if (error)
+			{
+				std::filesystem::remove(temporaryFilename, error);
+			}
+		}
+	}
+
+	bool Utils::LoadCachedOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding, ObjStatistics* pStatistics)
+	{
+		SourceKey key{};
+
+		if (!GetSourceKey(filename, key))
+			return false;
+
+		const std::string cacheFilename = filename + ".meshcache";
+		bool isWriteTimeOutdated{};
+		uint64_t sourceHash{};
+
+		if (ReadCache(cacheFilename, filename, key, flipAxisAndWinding, vertices, indices, isWriteTimeOutdated, sourceHash))
+		{
+			// Same content under a new write time, stored again so the next start does not hash the OBJ
+			if (isWriteTimeOutdated)
+			{
+				WriteCache(cacheFilename, key, sourceHash, flipAxisAndWinding, vertices, indices);
+			}
+
+			if (pStatistics)
+			{
+				pStatistics->faceCorners = uint32_t(indices.size());
+				pStatistics->uniqueVertices = uint32_t(vertices.size());
+				pStatistics->isFromCache = true;
+			}
+
+			return true;
+		}
+
+		if (!LoadOBJ(filename, vertices, indices, flipAxisAndWinding, pStatistics))
+			return false;
+
+		WriteCache(cacheFilename, key, HashFile(filename), flipAxisAndWinding, vertices, indices);
+
+		return true;
+	}
+}
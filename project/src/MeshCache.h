@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Utils.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		// Loads an OBJ through a binary cache next to it, named like the OBJ with ".meshcache" appended
+		// The cache holds the finished vertices and indices, so a hit only maps the file and copies two blobs
+		// It is keyed by the size, write time and content hash of the OBJ, a missing or stale cache is rebuilt with LoadOBJ
+		bool LoadCachedOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true, ObjStatistics* pStatistics = nullptr);
+	}
+}
@@ -0,0 +1,253 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Vector2.h"
+
+namespace dae
+{
+	// How a texture is filtered, every mode picks its mip level from the uv derivatives
+	enum class TextureFilter
+	{
+		Nearest,
+		Bilinear,
+		Trilinear
+	};
+
+	// How the texels of every mip level are ordered in memory
+	// Tiled stores 8x8 blocks of texels together, in Z-order within the block, so a filter footprint rarely spans more than one cache line
+	enum class TextureLayout
+	{
+		Linear,
+		Tiled
+	};
+
+	// The mip levels of a texture and all of the sampling that does not depend on what a texel holds:
+	// level of detail, repeat addressing, the texel order of the layout and the three filters
+	// Traits::Decode turns a Texel into a Traits::Value, Traits::Lerp blends two values
+	// Defined inline, it runs for every shaded pixel
+	template<typename Texel, typename Traits>
+	class MipChain
+	{
+	public:
+		using Value = typename Traits::Value;
+
+		struct Level
+		{
+			int width{};
+			int height{};
+			int tilesPerRow{};
+			std::vector<Texel> texels{};
+		};
+
+		MipChain() = default;
+
+		// levels hold their texels row by row, level 0 first and every next level half the size down to 1x1
+		MipChain(std::vector<Level> levels, TextureLayout layout);
+
+		int GetLevelCount() const;
+		int GetWidth(int level) const;
+		int GetHeight(int level) const;
+
+		// x and y have to lie within the level
+		const Texel& GetTexel(int level, int x, int y) const;
+
+		// uvDdx and uvDdy are the change in uv to the next pixel on the right and below
+		Value Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, TextureFilter filter) const;
+		Value SampleNearest(int level, const Vector2& uv) const;
+		Value SampleBilinear(int level, const Vector2& uv) const;
+
+	private:
+		static constexpr int TILE_SIZE{ 8 };
+
+		// Spreads the three bits of a coordinate within a tile to every other bit, x and y interleaved give the Z-order
+		static constexpr uint32_t MORTON_SPREAD[TILE_SIZE]{ 0b000000, 0b000001, 0b000100, 0b000101, 0b010000, 0b010001, 0b010100, 0b010101 };
+
+		std::vector<Level> m_Levels{};
+		bool m_IsPowerOfTwo{};
+		TextureLayout m_Layout{};
+
+		void ConvertToTiled(Level& level) const;
+		size_t GetTexelIndex(const Level& level, int x, int y) const;
+		float CalculateLevelOfDetail(const Vector2& uvDdx, const Vector2& uvDdy) const;
+		Value FetchTexel(int level, int x, int y) const;
+	};
+
+	template<typename Texel, typename Traits>
+	MipChain<Texel, Traits>::MipChain(std::vector<Level> levels, TextureLayout layout) :
+		m_Levels{ std::move(levels) },
+		m_Layout{ layout }
+	{
+		const int width = m_Levels[0].width;
+		const int height = m_Levels[0].height;
+		m_IsPowerOfTwo = (width & (width - 1)) == 0 && (height & (height - 1)) == 0;
+
+		// The levels are built from linear data, reordering comes last
+		if (m_Layout == TextureLayout::Tiled)
+		{
+			for (Level& level : m_Levels)
+			{
+				ConvertToTiled(level);
+			}
+		}
+	}
+
+	template<typename Texel, typename Traits>
+	int MipChain<Texel, Traits>::GetLevelCount() const
+	{
+		return int(m_Levels.size());
+	}
+
+	template<typename Texel, typename Traits>
+	int MipChain<Texel, Traits>::GetWidth(int level) const
+	{
+		return m_Levels[level].width;
+	}
+
+	template<typename Texel, typename Traits>
+	int MipChain<Texel, Traits>::GetHeight(int level) const
+	{
+		return m_Levels[level].height;
+	}
+
+	template<typename Texel, typename Traits>
+	const Texel& MipChain<Texel, Traits>::GetTexel(int level, int x, int y) const
+	{
+		return m_Levels[level].texels[GetTexelIndex(m_Levels[level], x, y)];
+	}
+
+	template<typename Texel, typename Traits>
+	typename MipChain<Texel, Traits>::Value MipChain<Texel, Traits>::Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, TextureFilter filter) const
+	{
+		const int lastLevel = int(m_Levels.size()) - 1;
+		const float levelOfDetail = std::clamp(CalculateLevelOfDetail(uvDdx, uvDdy), 0.0f, float(lastLevel));
+
+		switch (filter)
+		{
+		case TextureFilter::Nearest:
+			return SampleNearest(int(levelOfDetail + 0.5f), uv);
+		case TextureFilter::Bilinear:
+			return SampleBilinear(int(levelOfDetail + 0.5f), uv);
+		case TextureFilter::Trilinear:
+		default:
+		{
+			// Blends the two closest levels
+			const int level = std::min(int(levelOfDetail), lastLevel);
+			const float factor = levelOfDetail - float(level);
+
+			if (level == lastLevel || factor == 0.0f)
+			{
+				return SampleBilinear(level, uv);
+			}
+
+			return Traits::Lerp(SampleBilinear(level, uv), SampleBilinear(level + 1, uv), factor);
+		}
+		}
+	}
+
+	template<typename Texel, typename Traits>
+	typename MipChain<Texel, Traits>::Value MipChain<Texel, Traits>::SampleNearest(int level, const Vector2& uv) const
+	{
+		const Level& mipLevel = m_Levels[level];
+
+		return FetchTexel(level, int(std::floor(uv.x * mipLevel.width)), int(std::floor(uv.y * mipLevel.height)));
+	}
+
+	template<typename Texel, typename Traits>
+	typename MipChain<Texel, Traits>::Value MipChain<Texel, Traits>::SampleBilinear(int level, const Vector2& uv) const
+	{
+		const Level& mipLevel = m_Levels[level];
+
+		// Texel centers sit at half coordinates
+		const float x = uv.x * mipLevel.width - 0.5f;
+		const float y = uv.y * mipLevel.height - 0.5f;
+
+		const float floorX = std::floor(x);
+		const float floorY = std::floor(y);
+
+		const float factorX = x - floorX;
+		const float factorY = y - floorY;
+
+		const int texelX = int(floorX);
+		const int texelY = int(floorY);
+
+		const Value top = Traits::Lerp(FetchTexel(level, texelX, texelY), FetchTexel(level, texelX + 1, texelY), factorX);
+		const Value bottom = Traits::Lerp(FetchTexel(level, texelX, texelY + 1), FetchTexel(level, texelX + 1, texelY + 1), factorX);
+
+		return Traits::Lerp(top, bottom, factorY);
+	}
+
+	template<typename Texel, typename Traits>
+	void MipChain<Texel, Traits>::ConvertToTiled(Level& level) const
+	{
+		// Partial tiles at the edges are padded, so every tile starts at a multiple of 64 texels
+		level.tilesPerRow = (level.width + TILE_SIZE - 1) / TILE_SIZE;
+		const int tilesPerColumn = (level.height + TILE_SIZE - 1) / TILE_SIZE;
+
+		std::vector<Texel> tiledTexels(size_t(level.tilesPerRow) * tilesPerColumn * TILE_SIZE * TILE_SIZE);
+
+		for (int y{ 0 }; y < level.height; ++y)
+		{
+			for (int x{ 0 }; x < level.width; ++x)
+			{
+				tiledTexels[GetTexelIndex(level, x, y)] = level.texels[size_t(y) * level.width + x];
+			}
+		}
+
+		level.texels = std::move(tiledTexels);
+	}
+
+	template<typename Texel, typename Traits>
+	size_t MipChain<Texel, Traits>::GetTexelIndex(const Level& level, int x, int y) const
+	{
+		if (m_Layout == TextureLayout::Linear)
+		{
+			return size_t(y) * level.width + x;
+		}
+
+		// Coordinates are already wrapped, so unsigned division by the tile size is a shift
+		const uint32_t tileX = uint32_t(x) / TILE_SIZE;
+		const uint32_t tileY = uint32_t(y) / TILE_SIZE;
+		const size_t tileIndex = size_t(tileY) * uint32_t(level.tilesPerRow) + tileX;
+
+		return tileIndex * TILE_SIZE * TILE_SIZE + (MORTON_SPREAD[uint32_t(x) % TILE_SIZE] | (MORTON_SPREAD[uint32_t(y) % TILE_SIZE] << 1));
+	}
+
+	template<typename Texel, typename Traits>
+	float MipChain<Texel, Traits>::CalculateLevelOfDetail(const Vector2& uvDdx, const Vector2& uvDdy) const
+	{
+		// Texels crossed by a step of one pixel, along the axis where the texture shrinks the most
+		const Level& baseLevel = m_Levels[0];
+
+		const Vector2 texelDdx{ uvDdx.x * baseLevel.width, uvDdx.y * baseLevel.height };
+		const Vector2 texelDdy{ uvDdy.x * baseLevel.width, uvDdy.y * baseLevel.height };
+
+		const float footprint = std::max(texelDdx.SqrMagnitude(), texelDdy.SqrMagnitude());
+
+		// log2 of the length, the square root folded into the halving
+		return 0.5f * std::log2(std::max(footprint, 1.0f));
+	}
+
+	template<typename Texel, typename Traits>
+	typename MipChain<Texel, Traits>::Value MipChain<Texel, Traits>::FetchTexel(int level, int x, int y) const
+	{
+		const Level& mipLevel = m_Levels[level];
+
+		// Repeat addressing, a mask when the sides allow it
+		if (m_IsPowerOfTwo)
+		{
+			x &= mipLevel.width - 1;
+			y &= mipLevel.height - 1;
+		}
+		else
+		{
+			x %= mipLevel.width;
+			y %= mipLevel.height;
+			x += x < 0 ? mipLevel.width : 0;
+			y += y < 0 ? mipLevel.height : 0;
+		}
+
+		return Traits::Decode(mipLevel.texels[GetTexelIndex(mipLevel, x, y)]);
+	}
+}
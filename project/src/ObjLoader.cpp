@@ -0,0 +1,252 @@
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <execution>
+#include <thread>
+
+#include "MappedFile.h"
+
+namespace dae
+{
+	namespace
+	{
+		// Everything one chunk of the file declares, face corners already use indices into the whole file
+		struct ObjChunk
+		{
+			std::vector<Vector3> positions{};
+			std::vector<Vector2> UVs{};
+			std::vector<Vector3> normals{};
+			std::vector<Utils::ObjCorner> corners{};
+			bool isValid{ true };
+		};
+
+		// Chunks of at least a megabyte, so small files do not pay for the threads
+		constexpr size_t MIN_CHUNK_SIZE{ 1 << 20 };
+
+		bool IsSpace(char character)
+		{
+			return character == ' ' || character == '\t';
+		}
+
+		const char* SkipSpaces(const char* pCurrent, const char* pEnd)
+		{
+			while (pCurrent < pEnd && IsSpace(*pCurrent)) ++pCurrent;
+
+			return pCurrent;
+		}
+
+		// The start of the next line, or the end when this is the last one
+		const char* SkipLine(const char* pCurrent, const char* pEnd)
+		{
+			const char* pNewLine = static_cast<const char*>(std::memchr(pCurrent, '\n', size_t(pEnd - pCurrent)));
+
+			return pNewLine ? pNewLine + 1 : pEnd;
+		}
+
+		// nullptr when there is no number
+		template<typename T>
+		const char* ParseNumber(const char* pCurrent, const char* pEnd, T& value)
+		{
+			pCurrent = SkipSpaces(pCurrent, pEnd);
+
+			const std::from_chars_result result = std::from_chars(pCurrent, pEnd, value);
+
+			return result.ec == std::errc{} ? result.ptr : nullptr;
+		}
+
+		// A fixed number of floats in a row, nullptr when one of them is missing
+		template<size_t Count>
+		const char* ParseFloats(const char* pCurrent, const char* pEnd, float(&values)[Count])
+		{
+			for (float& value : values)
+			{
+				pCurrent = ParseNumber(pCurrent, pEnd, value);
+
+				if (!pCurrent)
+					return nullptr;
+			}
+
+			return pCurrent;
+		}
+
+		// position, position/uv, position//normal or position/uv/normal
+		const char* ParseCorner(const char* pCurrent, const char* pEnd, Utils::ObjCorner& corner)
+		{
+			pCurrent = ParseNumber(pCurrent, pEnd, corner.position);
+
+			if (!pCurrent || pCurrent == pEnd || *pCurrent != '/')
+				return pCurrent;
+
+			++pCurrent;
+
+			if (pCurrent < pEnd && *pCurrent != '/')
+			{
+				// Optional texture coordinate
+				pCurrent = ParseNumber(pCurrent, pEnd, corner.uv);
+
+				if (!pCurrent)
+					return nullptr;
+			}
+
+			if (pCurrent < pEnd && *pCurrent == '/')
+			{
+				// Optional vertex normal
+				pCurrent = ParseNumber(pCurrent + 1, pEnd, corner.normal);
+			}
+
+			return pCurrent;
+		}
+
+		bool ParseFace(const char* pCurrent, const char* pLineEnd, std::vector<Utils::ObjCorner>& corners)
+		{
+			Utils::ObjCorner first{};
+			Utils::ObjCorner previous{};
+			int cornerCount{ 0 };
+
+			while (true)
+			{
+				pCurrent = SkipSpaces(pCurrent, pLineEnd);
+
+				if (pCurrent == pLineEnd || *pCurrent == '\r' || *pCurrent == '\n')
+					break;
+
+				Utils::ObjCorner corner{};
+				pCurrent = ParseCorner(pCurrent, pLineEnd, corner);
+
+				if (!pCurrent)
+					return false;
+
+				// Every corner past the second closes a triangle with the first and the one before it
+				if (cornerCount >= 2)
+				{
+					corners.push_back(first);
+					corners.push_back(previous);
+					corners.push_back(corner);
+				}
+
+				if (cornerCount == 0) first = corner;
+				previous = corner;
+				++cornerCount;
+			}
+
+			return cornerCount >= 3;
+		}
+
+		void ParseChunk(const char* pBegin, const char* pEnd, ObjChunk& chunk)
+		{
+			for (const char* pLine = pBegin; pLine < pEnd;)
+			{
+				// Numbers never run on into the next line
+				const char* pLineEnd = SkipLine(pLine, pEnd);
+				const char* pCurrent = SkipSpaces(pLine, pLineEnd);
+
+				bool isValid{ true };
+
+				if (pLineEnd - pCurrent > 2 && pCurrent[0] == 'v')
+				{
+					if (IsSpace(pCurrent[1]))
+					{
+						//Vertex
+						float values[3]{};
+						isValid = ParseFloats(pCurrent + 2, pLineEnd, values) != nullptr;
+
+						chunk.positions.emplace_back(values[0], values[1], values[2]);
+					}
+					else if (pCurrent[1] == 't' && IsSpace(pCurrent[2]))
+					{
+						// Vertex TexCoord
+						float values[2]{};
+						isValid = ParseFloats(pCurrent + 3, pLineEnd, values) != nullptr;
+
+						chunk.UVs.emplace_back(values[0], 1 - values[1]);
+					}
+					else if (pCurrent[1] == 'n' && IsSpace(pCurrent[2]))
+					{
+						// Vertex Normal
+						float values[3]{};
+						isValid = ParseFloats(pCurrent + 3, pLineEnd, values) != nullptr;
+
+						chunk.normals.emplace_back(values[0], values[1], values[2]);
+					}
+				}
+				else if (pLineEnd - pCurrent > 1 && pCurrent[0] == 'f' && IsSpace(pCurrent[1]))
+				{
+					// Faces, triangles or polygons
+					isValid = ParseFace(pCurrent + 2, pLineEnd, chunk.corners);
+				}
+
+				// Comments, groups, materials and smoothing groups are skipped along with the rest of the line
+
+				if (!isValid)
+				{
+					chunk.isValid = false;
+					return;
+				}
+
+				pLine = pLineEnd;
+			}
+		}
+	}
+
+	bool Utils::LoadOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding, ObjStatistics* pStatistics, bool isMultithreaded)
+	{
+		const MappedFile file{ filename };
+
+		if (!file.IsOpen())
+			return false;
+
+		const char* pBegin = file.GetData();
+		const char* pEnd = pBegin + file.GetSize();
+
+		const size_t maxChunkCount = isMultithreaded ? std::max(std::thread::hardware_concurrency(), 1u) : 1;
+		const size_t chunkCount = std::clamp(file.GetSize() / MIN_CHUNK_SIZE, size_t(1), maxChunkCount);
+
+		// Every chunk but the first starts right after a line end
+		std::vector<const char*> boundaries(chunkCount + 1, pEnd);
+		boundaries[0] = pBegin;
+
+		for (size_t index{ 1 }; index < chunkCount; ++index)
+		{
+			boundaries[index] = SkipLine(std::max(pBegin + file.GetSize() * index / chunkCount, boundaries[index - 1]), pEnd);
+		}
+
+		std::vector<ObjChunk> chunks(chunkCount);
+
+		std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&chunks, &boundaries](ObjChunk& chunk)
+			{
+				const size_t index = size_t(&chunk - chunks.data());
+
+				ParseChunk(boundaries[index], boundaries[index + 1], chunk);
+			});
+
+		// Attribute indices count from the start of the file, so the chunks are appended in order
+		std::vector<Vector3> positions{};
+		std::vector<Vector2> UVs{};
+		std::vector<Vector3> normals{};
+		std::vector<ObjCorner> corners{};
+
+		size_t cornerCount{};
+
+		for (const ObjChunk& chunk : chunks)
+		{
+			if (!chunk.isValid)
+				return false;
+
+			cornerCount += chunk.corners.size();
+		}
+
+		corners.reserve(cornerCount);
+
+		for (const ObjChunk& chunk : chunks)
+		{
+			positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+			UVs.insert(UVs.end(), chunk.UVs.begin(), chunk.UVs.end());
+			normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+			corners.insert(corners.end(), chunk.corners.begin(), chunk.corners.end());
+		}
+
+		return BuildVertices(positions, UVs, normals, corners, vertices, indices, flipAxisAndWinding, pStatistics);
+	}
+}
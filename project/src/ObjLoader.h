@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Utils.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		// Same result as ParseOBJ, for files where startup would otherwise be spent in operator>>
+		// The file is mapped into memory and scanned with a tokenizer of its own, numbers go through std::from_chars
+		// Large files are cut into chunks at line ends that are parsed in parallel, merging keeps the order of the file
+		// Faces with more than three corners are split into a fan
+		bool LoadOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true, ObjStatistics* pStatistics = nullptr, bool isMultithreaded = true);
+	}
+}
@@ -0,0 +1,207 @@
+#include "PowPolynomial.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <emmintrin.h>
+#include <utility>
+
+namespace dae
+{
+	namespace
+	{
+		// Horner's scheme, the same coefficient is shared by both halves of the span
+		void EvaluatePolynomial(const float* pCoefficients, int degree, __m128& firstHalf, __m128& secondHalf)
+		{
+			__m128 firstSum = _mm_set1_ps(pCoefficients[degree]);
+			__m128 secondSum = firstSum;
+
+			for (int index{ degree - 1 }; index >= 0; --index)
+			{
+				const __m128 coefficient = _mm_set1_ps(pCoefficients[index]);
+
+				firstSum = _mm_add_ps(_mm_mul_ps(firstSum, firstHalf), coefficient);
+				secondSum = _mm_add_ps(_mm_mul_ps(secondSum, secondHalf), coefficient);
+			}
+
+			firstHalf = firstSum;
+			secondHalf = secondSum;
+		}
+	}
+
+	PowPolynomial::PowPolynomial(float maxExponent, float maxError)
+	{
+		// Half of maxError goes to each polynomial
+		// An error in log2 is picked up times ln(2) * exponent * pow(base, exponent), where pow(base, exponent) is at most one
+		const double log2Factor = std::log(2.0) * std::max(double(maxExponent), 1.0);
+
+		m_Log2Degree = FitPolynomial([](double mantissa) { return std::log2(1.0 + mantissa); }, 0.5 * maxError / log2Factor, m_Log2Coefficients);
+
+		// The integer part of the power only ever scales the error of exp2 down
+		m_Exp2Degree = FitPolynomial([](double fraction) { return std::exp2(fraction); }, 0.5 * maxError, m_Exp2Coefficients);
+	}
+
+	void PowPolynomial::Pow(const float base[LANE_COUNT], const float exponent[LANE_COUNT], float result[LANE_COUNT]) const
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 minNormal = _mm_set1_ps(FLT_MIN);
+		const __m128 minPower = _mm_set1_ps(MIN_POWER);
+		const __m128i mantissaMask = _mm_set1_epi32(0x7fffff);
+		const __m128i exponentBias = _mm_set1_epi32(127);
+
+		__m128 bases[2]{ _mm_loadu_ps(base), _mm_loadu_ps(base + 4) };
+		__m128 exponents[2]{ _mm_loadu_ps(exponent), _mm_loadu_ps(exponent + 4) };
+		__m128 log2s[2]{};
+		__m128 mantissas[2]{};
+
+		for (int half{ 0 }; half < 2; ++half)
+		{
+			const __m128i baseBits = _mm_castps_si128(bases[half]);
+
+			log2s[half] = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(baseBits, 23), exponentBias));
+			mantissas[half] = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(baseBits, mantissaMask), _mm_castps_si128(one))), one);
+		}
+
+		EvaluatePolynomial(m_Log2Coefficients, m_Log2Degree, mantissas[0], mantissas[1]);
+
+		__m128i integers[2]{};
+		__m128 fractions[2]{};
+		__m128 isAboveMinPower[2]{};
+
+		for (int half{ 0 }; half < 2; ++half)
+		{
+			const __m128 power = _mm_max_ps(_mm_mul_ps(exponents[half], _mm_add_ps(log2s[half], mantissas[half])), minPower);
+			isAboveMinPower[half] = _mm_cmpgt_ps(power, minPower);
+
+			// Truncating rounds the negative powers up, the compare mask is -1 where a step down is still needed
+			const __m128i truncated = _mm_cvttps_epi32(power);
+			integers[half] = _mm_add_epi32(truncated, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), power)));
+			fractions[half] = _mm_sub_ps(power, _mm_cvtepi32_ps(integers[half]));
+		}
+
+		EvaluatePolynomial(m_Exp2Coefficients, m_Exp2Degree, fractions[0], fractions[1]);
+
+		for (int half{ 0 }; half < 2; ++half)
+		{
+			const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(integers[half], exponentBias), 23));
+			const __m128 power = _mm_and_ps(_mm_mul_ps(fractions[half], scale), isAboveMinPower[half]);
+
+			// Zero has no logarithm, like std::pow anything to the power zero is one
+			const __m128 isZeroBase = _mm_cmpnge_ps(bases[half], minNormal);
+			const __m128 zeroPower = _mm_and_ps(_mm_cmpeq_ps(exponents[half], zero), one);
+
+			_mm_storeu_ps(result + 4 * half, _mm_or_ps(_mm_and_ps(isZeroBase, zeroPower), _mm_andnot_ps(isZeroBase, power)));
+		}
+	}
+
+	int PowPolynomial::GetLog2Degree() const
+	{
+		return m_Log2Degree;
+	}
+
+	int PowPolynomial::GetExp2Degree() const
+	{
+		return m_Exp2Degree;
+	}
+
+	template<typename Function>
+	int PowPolynomial::FitPolynomial(Function function, double maxError, float coefficients[MAX_DEGREE + 1])
+	{
+		// The smallest degree whose float coefficients stay within maxError on a fine grid over [0, 1]
+		constexpr int GRID_STEPS{ 4096 };
+
+		int degree{ 1 };
+
+		for (; degree < MAX_DEGREE; ++degree)
+		{
+			InterpolateChebyshev(function, degree, coefficients);
+
+			double maxDeviation{};
+
+			for (int step{ 0 }; step <= GRID_STEPS; ++step)
+			{
+				const double x = double(step) / GRID_STEPS;
+				double sum = coefficients[degree];
+
+				for (int index{ degree - 1 }; index >= 0; --index)
+				{
+					sum = sum * x + coefficients[index];
+				}
+
+				maxDeviation = std::max(maxDeviation, std::abs(sum - function(x)));
+			}
+
+			if (maxDeviation <= maxError)
+			{
+				return degree;
+			}
+		}
+
+		InterpolateChebyshev(function, degree, coefficients);
+		return degree;
+	}
+
+	template<typename Function>
+	void PowPolynomial::InterpolateChebyshev(Function function, int degree, float coefficients[MAX_DEGREE + 1])
+	{
+		constexpr double PI{ 3.14159265358979323846 };
+		const int nodeCount = degree + 1;
+
+		// The Vandermonde system of the nodes, one row per node with the function value as the last column
+		double system[MAX_DEGREE + 1][MAX_DEGREE + 2]{};
+
+		for (int row{ 0 }; row < nodeCount; ++row)
+		{
+			const double node = 0.5 + 0.5 * std::cos(PI * (2 * row + 1) / (2 * nodeCount));
+			double power{ 1.0 };
+
+			for (int column{ 0 }; column < nodeCount; ++column)
+			{
+				system[row][column] = power;
+				power *= node;
+			}
+
+			system[row][nodeCount] = function(node);
+		}
+
+		// Gaussian elimination with partial pivoting, in double since the system gets badly conditioned quickly
+		for (int pivot{ 0 }; pivot < nodeCount; ++pivot)
+		{
+			int bestRow{ pivot };
+
+			for (int row{ pivot + 1 }; row < nodeCount; ++row)
+			{
+				if (std::abs(system[row][pivot]) > std::abs(system[bestRow][pivot]))
+				{
+					bestRow = row;
+				}
+			}
+
+			std::swap(system[pivot], system[bestRow]);
+
+			for (int row{ pivot + 1 }; row < nodeCount; ++row)
+			{
+				const double factor = system[row][pivot] / system[pivot][pivot];
+
+				for (int column{ pivot }; column <= nodeCount; ++column)
+				{
+					system[row][column] -= factor * system[pivot][column];
+				}
+			}
+		}
+
+		for (int row{ nodeCount - 1 }; row >= 0; --row)
+		{
+			double sum = system[row][nodeCount];
+
+			for (int column{ row + 1 }; column < nodeCount; ++column)
+			{
+				sum -= system[row][column] * system[column][nodeCount];
+			}
+
+			system[row][nodeCount] = sum / system[row][row];
+			coefficients[row] = float(system[row][nodeCount]);
+		}
+	}
+}
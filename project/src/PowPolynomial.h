@@ -0,0 +1,50 @@
+#pragma once
+
+namespace dae
+{
+	// Approximates pow(base, exponent) as exp2(exponent * log2(base)), with both sides evaluated as polynomials
+	// Meant for the specular term: base in [0, 1] and exponent in [0, maxExponent]
+	// The degrees are picked so the result never deviates more than maxError from std::pow over that domain
+	class PowPolynomial
+	{
+	public:
+		// One raster span per call, evaluated as two SSE halves
+		static constexpr int LANE_COUNT{ 8 };
+
+		// What the renderer asks for in the Phong term, a quarter of a color step, SpecularBenchmarks checks it holds
+		static constexpr float SPECULAR_MAX_ERROR{ 1.0f / 1024.0f };
+
+		PowPolynomial() = default;
+		PowPolynomial(float maxExponent, float maxError);
+
+		// Lanes that are not needed can hold anything in the domain, their result is simply ignored
+		void Pow(const float base[LANE_COUNT], const float exponent[LANE_COUNT], float result[LANE_COUNT]) const;
+
+		int GetLog2Degree() const;
+		int GetExp2Degree() const;
+
+	private:
+		// Past this the rounding of the floats themselves dominates
+		static constexpr int MAX_DEGREE{ 8 };
+
+		// Smaller powers of two come out as zero, far below what shows in a color
+		// Tiny results would otherwise turn into denormals once the shading scales them, which are slow to compute with
+		static constexpr float MIN_POWER{ -64.0f };
+
+		// log2 of the mantissa 1 + m for m in [0, 1), the exponent bits add the integer part
+		float m_Log2Coefficients[MAX_DEGREE + 1]{};
+		int m_Log2Degree{};
+
+		// exp2 of the fraction of the power, the integer part goes straight into the float exponent
+		float m_Exp2Coefficients[MAX_DEGREE + 1]{};
+		int m_Exp2Degree{};
+
+		// Fits the function on [0, 1] with the smallest degree that stays within maxError, returns that degree
+		template<typename Function>
+		static int FitPolynomial(Function function, double maxError, float coefficients[MAX_DEGREE + 1]);
+
+		// Interpolates the function in the Chebyshev nodes of [0, 1], which keeps the error close to the best a polynomial can do
+		template<typename Function>
+		static void InterpolateChebyshev(Function function, int degree, float coefficients[MAX_DEGREE + 1]);
+	};
+}
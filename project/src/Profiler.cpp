@@ -0,0 +1,128 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dae
+{
+	namespace Profiler
+	{
+		namespace
+		{
+			using Clock = std::chrono::steady_clock;
+
+			const Clock::time_point g_Epoch{ Clock::now() };
+
+			struct Event
+			{
+				const char* pName{};
+				int64_t start{};
+				int64_t end{};
+			};
+
+			struct ThreadBuffer
+			{
+				std::unique_ptr<Event[]> pEvents{ new Event[EVENTS_PER_THREAD] };
+				// Every event ever recorded, the one after the last sits at this index modulo the capacity
+				std::atomic<uint64_t> eventCount{};
+				uint32_t threadIndex{};
+			};
+
+			std::mutex g_BuffersMutex{};
+			std::vector<std::unique_ptr<ThreadBuffer>> g_Buffers{};
+
+			// Only the first event of a thread takes the lock, buffers stay alive until exit like the thread pool does
+			ThreadBuffer& GetThreadBuffer()
+			{
+				thread_local ThreadBuffer* pBuffer{ nullptr };
+
+				if (!pBuffer)
+				{
+					const std::lock_guard lock{ g_BuffersMutex };
+
+					g_Buffers.push_back(std::make_unique<ThreadBuffer>());
+					pBuffer = g_Buffers.back().get();
+					pBuffer->threadIndex = uint32_t(g_Buffers.size() - 1);
+				}
+
+				return *pBuffer;
+			}
+
+			double ToMicroseconds(int64_t nanoseconds)
+			{
+				return double(nanoseconds) / 1000.0;
+			}
+		}
+
+		int64_t GetTimestamp()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_Epoch).count();
+		}
+
+		void RecordEvent(const char* pName, int64_t start, int64_t end)
+		{
+			ThreadBuffer& buffer = GetThreadBuffer();
+
+			// Only this thread writes the count, the release makes the event visible before it is counted
+			const uint64_t eventIndex = buffer.eventCount.load(std::memory_order_relaxed);
+			buffer.pEvents[eventIndex % EVENTS_PER_THREAD] = Event{ pName, start, end };
+			buffer.eventCount.store(eventIndex + 1, std::memory_order_release);
+		}
+
+		bool WriteTrace(const std::string& filename)
+		{
+			if (!IsCompiledIn())
+				return false;
+
+			std::ofstream file{ filename };
+
+			if (!file)
+				return false;
+
+			const std::lock_guard lock{ g_BuffersMutex };
+
+			file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+			file.setf(std::ios::fixed);
+			file.precision(3);
+
+			bool isFirstEvent{ true };
+
+			for (const std::unique_ptr<ThreadBuffer>& pBuffer : g_Buffers)
+			{
+				// The first thread to record is the one calling Render, the rest belong to the thread pool
+				file << (isFirstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << pBuffer->threadIndex
+					<< ",\"args\":{\"name\":\"" << (pBuffer->threadIndex == 0 ? "Main" : "Worker") << ' ' << pBuffer->threadIndex << "\"}}";
+				isFirstEvent = false;
+
+				const uint64_t eventCount = pBuffer->eventCount.load(std::memory_order_acquire);
+				const uint64_t firstEvent = eventCount - std::min<uint64_t>(eventCount, EVENTS_PER_THREAD);
+
+				for (uint64_t eventIndex{ firstEvent }; eventIndex < eventCount; ++eventIndex)
+				{
+					const Event& event = pBuffer->pEvents[eventIndex % EVENTS_PER_THREAD];
+
+					file << ",\n{\"name\":\"" << event.pName << "\",\"cat\":\"renderer\",\"ph\":\"X\",\"pid\":1,\"tid\":" << pBuffer->threadIndex
+						<< ",\"ts\":" << ToMicroseconds(event.start) << ",\"dur\":" << ToMicroseconds(event.end - event.start) << '}';
+				}
+			}
+
+			file << "\n]}\n";
+
+			return bool(file);
+		}
+
+		bool IsCompiledIn()
+		{
+#if defined(ENABLE_PROFILER)
+			return true;
+#else
+			return false;
+#endif
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Scoped timers around the stages of a frame, exported as a Chrome trace (chrome://tracing or ui.perfetto.dev)
+// Only compiled in with ENABLE_PROFILER, otherwise PROFILE_SCOPE expands to nothing and the functions below do nothing
+#if defined(ENABLE_PROFILER)
+#define PROFILE_CONCATENATE_INNER(first, second) first##second
+#define PROFILE_CONCATENATE(first, second) PROFILE_CONCATENATE_INNER(first, second)
+// The name has to be a string literal, only the pointer is stored
+#define PROFILE_SCOPE(name) const dae::Profiler::ScopedTimer PROFILE_CONCATENATE(profileScope, __LINE__){ name }
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+namespace dae
+{
+	namespace Profiler
+	{
+		// Every thread writes its events to its own ring buffer, allocated the first time the thread records anything
+		// Once full the oldest events are overwritten, so a trace holds the last frames before it was written
+		constexpr uint32_t EVENTS_PER_THREAD{ 1u << 16 };
+
+		// Nanoseconds since the profiler was first used
+		int64_t GetTimestamp();
+
+		// Adds a finished scope to the ring buffer of the calling thread
+		void RecordEvent(const char* pName, int64_t start, int64_t end);
+
+		// Writes the events of every ring buffer as Chrome trace JSON, meant to be called between frames
+		// False when the file could not be written or the profiler is compiled out
+		bool WriteTrace(const std::string& filename);
+
+		bool IsCompiledIn();
+
+		class ScopedTimer final
+		{
+		public:
+			explicit ScopedTimer(const char* pName) :
+				m_pName{ pName },
+				m_Start{ GetTimestamp() }
+			{
+			}
+
+			~ScopedTimer()
+			{
+				RecordEvent(m_pName, m_Start, GetTimestamp());
+			}
+
+			ScopedTimer(const ScopedTimer&) = delete;
+			ScopedTimer(ScopedTimer&&) noexcept = delete;
+			ScopedTimer& operator=(const ScopedTimer&) = delete;
+			ScopedTimer& operator=(ScopedTimer&&) noexcept = delete;
+
+		private:
+			const char* m_pName;
+			int64_t m_Start;
+		};
+	}
+}
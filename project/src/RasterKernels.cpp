@@ -0,0 +1,239 @@
+#include "RasterKernels.h"
+
+#include <cmath>
+#include <emmintrin.h>
+
+namespace dae
+{
+	namespace RasterKernels
+	{
+		KernelTable GetKernelTable(InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+			case InstructionSet::SSE42:
+				return KernelTable{ CoverageSpanSSE, TransformVerticesSSE };
+			case InstructionSet::AVX2:
+				return KernelTable{ CoverageSpanAVX2, TransformVerticesAVX2 };
+			case InstructionSet::AVX512:
+				return KernelTable{ CoverageSpanAVX512, TransformVerticesAVX512 };
+			default:
+				return KernelTable{ CoverageSpanScalar, TransformVerticesScalar };
+			}
+		}
+
+		uint32_t CoverageSpanScalar(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span)
+		{
+			uint32_t coverageMask{ 0 };
+			uint32_t insideMask{ 0 };
+
+			for (int lane{ 0 }; lane < SPAN_WIDTH; ++lane)
+			{
+				// Same operations in the same order as the SIMD kernel, so both produce identical bits
+				const float cross0 = spanCross[0] + float(lane) * setup.stepX[0];
+				const float cross1 = spanCross[1] + float(lane) * setup.stepX[1];
+				const float cross2 = spanCross[2] + float(lane) * setup.stepX[2];
+
+				if (cross0 < 0.0f || cross1 < 0.0f || cross2 < 0.0f) continue;
+
+				insideMask |= 1u << lane;
+
+				const float weightV0 = cross0 * setup.invTotalArea;
+				const float weightV1 = cross1 * setup.invTotalArea;
+				const float weightV2 = 1 - weightV0 - weightV1;
+
+				// z / w is linear in raster space
+				const float zBuffer = setup.depth[0] * weightV0 + setup.depth[1] * weightV1 + setup.depth[2] * weightV2;
+
+				if (zBuffer < 0 || zBuffer > 1) continue;
+				if (!(zBuffer < pDepth[lane])) continue;
+
+				span.weights[0][lane] = weightV0;
+				span.weights[1][lane] = weightV1;
+				span.weights[2][lane] = weightV2;
+				span.depth[lane] = zBuffer;
+
+				coverageMask |= 1u << lane;
+			}
+
+			span.insideMask = insideMask & laneMask;
+
+			return coverageMask & laneMask;
+		}
+
+		uint32_t CoverageSpanSSE(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span)
+		{
+			// The span is handled as two halves of 4 pixels
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 invTotalArea = _mm_set1_ps(setup.invTotalArea);
+
+			uint32_t coverageMask{ 0 };
+			span.insideMask = 0;
+
+			for (int half{ 0 }; half < 2; ++half)
+			{
+				const int firstLane = half * 4;
+				const __m128 laneOffsets = _mm_setr_ps(float(firstLane), float(firstLane + 1), float(firstLane + 2), float(firstLane + 3));
+
+				const __m128 cross0 = _mm_add_ps(_mm_set1_ps(spanCross[0]), _mm_mul_ps(laneOffsets, _mm_set1_ps(setup.stepX[0])));
+				const __m128 cross1 = _mm_add_ps(_mm_set1_ps(spanCross[1]), _mm_mul_ps(laneOffsets, _mm_set1_ps(setup.stepX[1])));
+				const __m128 cross2 = _mm_add_ps(_mm_set1_ps(spanCross[2]), _mm_mul_ps(laneOffsets, _mm_set1_ps(setup.stepX[2])));
+
+				__m128 inside = _mm_and_ps(_mm_cmpge_ps(cross0, zero), _mm_and_ps(_mm_cmpge_ps(cross1, zero), _mm_cmpge_ps(cross2, zero)));
+
+				if (_mm_movemask_ps(inside) == 0) continue;
+
+				span.insideMask |= (uint32_t(_mm_movemask_ps(inside)) << firstLane) & laneMask;
+
+				const __m128 weightV0 = _mm_mul_ps(cross0, invTotalArea);
+				const __m128 weightV1 = _mm_mul_ps(cross1, invTotalArea);
+				const __m128 weightV2 = _mm_sub_ps(_mm_sub_ps(one, weightV0), weightV1);
+
+				// z / w is linear in raster space
+				const __m128 zBuffer = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(setup.depth[0]), weightV0),
+					_mm_mul_ps(_mm_set1_ps(setup.depth[1]), weightV1)),
+					_mm_mul_ps(_mm_set1_ps(setup.depth[2]), weightV2));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(zBuffer, zero));
+				inside = _mm_and_ps(inside, _mm_cmple_ps(zBuffer, one));
+				inside = _mm_and_ps(inside, _mm_cmplt_ps(zBuffer, _mm_loadu_ps(pDepth + firstLane)));
+
+				_mm_storeu_ps(span.weights[0] + firstLane, weightV0);
+				_mm_storeu_ps(span.weights[1] + firstLane, weightV1);
+				_mm_storeu_ps(span.weights[2] + firstLane, weightV2);
+				_mm_storeu_ps(span.depth + firstLane, zBuffer);
+
+				coverageMask |= uint32_t(_mm_movemask_ps(inside)) << firstLane;
+			}
+
+			return coverageMask & laneMask;
+		}
+	
+		void TransformVerticesScalar(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end)
+		{
+			const float* matrix = setup.worldViewProjection;
+			const float* world = setup.world;
+
+			for (size_t index{ begin }; index < end; ++index)
+			{
+				const float x = input.position[0][index];
+				const float y = input.position[1][index];
+				const float z = input.position[2][index];
+
+				// Step 1. From world to Camera space + Step 3. Projection
+				const float clipX = matrix[0] * x + matrix[4] * y + matrix[8] * z + matrix[12];
+				const float clipY = matrix[1] * x + matrix[5] * y + matrix[9] * z + matrix[13];
+				const float clipZ = matrix[2] * x + matrix[6] * y + matrix[10] * z + matrix[14];
+				const float clipW = matrix[3] * x + matrix[7] * y + matrix[11] * z + matrix[15];
+
+				output.clip[0][index] = clipX;
+				output.clip[1][index] = clipY;
+				output.clip[2][index] = clipZ;
+				output.clip[3][index] = clipW;
+
+				// Step 2. Perspective divide + Step 4. Converting to Raster Space (Screen Space)
+				output.raster[0][index] = (clipX / clipW + 1) * 0.5f * setup.width;
+				output.raster[1][index] = (1 - clipY / clipW) * 0.5f * setup.height;
+				output.raster[2][index] = clipZ / clipW;
+
+				output.uv[0][index] = input.uv[0][index];
+				output.uv[1][index] = input.uv[1][index];
+
+				// Step for additional info calculations
+				float toCamera[3]{};
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					output.normal[axis][index] = world[axis] * input.normal[0][index] + world[4 + axis] * input.normal[1][index] + world[8 + axis] * input.normal[2][index];
+					output.tangent[axis][index] = world[axis] * input.tangent[0][index] + world[4 + axis] * input.tangent[1][index] + world[8 + axis] * input.tangent[2][index];
+
+					toCamera[axis] = setup.cameraOrigin[axis] - (world[axis] * x + world[4 + axis] * y + world[8 + axis] * z + world[12 + axis]);
+				}
+
+				const float distance = std::sqrt(toCamera[0] * toCamera[0] + toCamera[1] * toCamera[1] + toCamera[2] * toCamera[2]);
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					output.viewDirection[axis][index] = toCamera[axis] / distance;
+				}
+			}
+		}
+
+		void TransformVerticesSSE(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end)
+		{
+			// Four vertices per iteration, every register holds one component of each of them
+			const float* matrix = setup.worldViewProjection;
+			const float* world = setup.world;
+
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 width = _mm_set1_ps(setup.width);
+			const __m128 height = _mm_set1_ps(setup.height);
+
+			// Row-major matrix times (x, y, z, w), one output component
+			const auto transform = [](const float* pMatrix, int component, __m128 x, __m128 y, __m128 z)
+				{
+					return _mm_add_ps(_mm_add_ps(
+						_mm_mul_ps(_mm_set1_ps(pMatrix[component]), x),
+						_mm_mul_ps(_mm_set1_ps(pMatrix[4 + component]), y)),
+						_mm_mul_ps(_mm_set1_ps(pMatrix[8 + component]), z));
+				};
+
+			size_t index{ begin };
+
+			for (; index + 4 <= end; index += 4)
+			{
+				const __m128 x = _mm_loadu_ps(input.position[0] + index);
+				const __m128 y = _mm_loadu_ps(input.position[1] + index);
+				const __m128 z = _mm_loadu_ps(input.position[2] + index);
+
+				__m128 clip[4];
+
+				for (int component{ 0 }; component < 4; ++component)
+				{
+					clip[component] = _mm_add_ps(transform(matrix, component, x, y, z), _mm_set1_ps(matrix[12 + component]));
+					_mm_storeu_ps(output.clip[component] + index, clip[component]);
+				}
+
+				_mm_storeu_ps(output.raster[0] + index, _mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_div_ps(clip[0], clip[3]), one), half), width));
+				_mm_storeu_ps(output.raster[1] + index, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(one, _mm_div_ps(clip[1], clip[3])), half), height));
+				_mm_storeu_ps(output.raster[2] + index, _mm_div_ps(clip[2], clip[3]));
+
+				_mm_storeu_ps(output.uv[0] + index, _mm_loadu_ps(input.uv[0] + index));
+				_mm_storeu_ps(output.uv[1] + index, _mm_loadu_ps(input.uv[1] + index));
+
+				const __m128 normalX = _mm_loadu_ps(input.normal[0] + index);
+				const __m128 normalY = _mm_loadu_ps(input.normal[1] + index);
+				const __m128 normalZ = _mm_loadu_ps(input.normal[2] + index);
+
+				const __m128 tangentX = _mm_loadu_ps(input.tangent[0] + index);
+				const __m128 tangentY = _mm_loadu_ps(input.tangent[1] + index);
+				const __m128 tangentZ = _mm_loadu_ps(input.tangent[2] + index);
+
+				__m128 toCamera[3];
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					_mm_storeu_ps(output.normal[axis] + index, transform(world, axis, normalX, normalY, normalZ));
+					_mm_storeu_ps(output.tangent[axis] + index, transform(world, axis, tangentX, tangentY, tangentZ));
+
+					toCamera[axis] = _mm_sub_ps(_mm_set1_ps(setup.cameraOrigin[axis]), _mm_add_ps(transform(world, axis, x, y, z), _mm_set1_ps(world[12 + axis])));
+				}
+
+				const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(toCamera[0], toCamera[0]),
+					_mm_mul_ps(toCamera[1], toCamera[1])),
+					_mm_mul_ps(toCamera[2], toCamera[2])));
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					_mm_storeu_ps(output.viewDirection[axis] + index, _mm_div_ps(toCamera[axis], distance));
+				}
+			}
+
+			TransformVerticesScalar(setup, input, output, index, end);
+		}
+	}
+}
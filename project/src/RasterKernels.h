@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+namespace dae
+{
+	// Per triangle constants for the span kernels
+	// The edge functions are ordered by the vertex they weigh, edge i is the one opposite to vertex i
+	struct EdgeSetup
+	{
+		float stepX[3]{};
+		float invTotalArea{};
+		float depth[3]{};
+	};
+
+	// Kernel output for the pixels of one span, only valid for the lanes set in the returned mask
+	struct PixelSpan
+	{
+		float weights[3][8]{};
+		float depth[8]{};
+		// Lanes inside the edges before the depth tests, limited to laneMask, always valid
+		uint32_t insideMask{};
+	};
+
+	// Per mesh constants for the vertex kernels, the matrices are row-major
+	struct VertexTransformSetup
+	{
+		float worldViewProjection[16]{};
+		float world[16]{};
+		float cameraOrigin[3]{};
+		float width{};
+		float height{};
+	};
+
+	// One array per vertex component, so the kernels can load a register worth of vertices at once
+	struct VertexInputStreams
+	{
+		const float* position[3]{};
+		const float* uv[2]{};
+		const float* normal[3]{};
+		const float* tangent[3]{};
+	};
+
+	struct VertexOutputStreams
+	{
+		float* clip[4]{};
+		float* raster[3]{};
+		float* uv[2]{};
+		float* normal[3]{};
+		float* tangent[3]{};
+		float* viewDirection[3]{};
+	};
+
+	namespace RasterKernels
+	{
+		constexpr int SPAN_WIDTH{ 8 };
+
+		// Evaluates coverage and interpolated depth for the 8 pixels starting at the pixel where the edge functions equal spanCross
+		// Returns a bit per pixel that is inside the triangle, within [0, 1] and closer than pDepth, limited to laneMask
+		using CoverageSpanFunction = uint32_t(*)(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span);
+
+		// Runs the vertex stage for the vertices in [begin, end): clip and raster position, world space normal and tangent
+		// and the normalized direction to the camera, the raster position is meaningless for vertices that get clipped
+		using TransformVerticesFunction = void(*)(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end);
+
+		// Only the span and vertex kernels get a build per instruction set, their files include nothing but this header
+		// Shading and texture sampling stay in the baseline build: Renderer.cpp built for AVX2 renders the same frames about 7% faster,
+		// but it also emits AVX2 copies of the inline math, camera and texture code, and the linker may keep those for the whole program
+		// A shading kernel only pays off once it is written against plain data like the kernels below
+		struct KernelTable
+		{
+			CoverageSpanFunction coverageSpan{};
+			TransformVerticesFunction transformVertices{};
+		};
+
+		// Kernels built for the given instruction set, selected once at startup
+		KernelTable GetKernelTable(InstructionSet instructionSet);
+
+		uint32_t CoverageSpanScalar(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span);
+		uint32_t CoverageSpanSSE(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span);
+		uint32_t CoverageSpanAVX2(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span);
+		uint32_t CoverageSpanAVX512(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span);
+
+		void TransformVerticesScalar(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end);
+		void TransformVerticesSSE(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end);
+		void TransformVerticesAVX2(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end);
+		void TransformVerticesAVX512(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end);
+	}
+}
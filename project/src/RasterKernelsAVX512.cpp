@@ -0,0 +1,131 @@
+// Built with AVX-512 (F and VL) enabled, only called when the CPU supports it
+#include "RasterKernels.h"
+
+#include <immintrin.h>
+
+namespace dae
+{
+	namespace RasterKernels
+	{
+		uint32_t CoverageSpanAVX512(const EdgeSetup& setup, const float spanCross[3], const float* pDepth, uint32_t laneMask, PixelSpan& span)
+		{
+			// Same math as the AVX2 kernel, the compares go straight into mask registers
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 invTotalArea = _mm256_set1_ps(setup.invTotalArea);
+			const __m256 laneOffsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+			const __m256 cross0 = _mm256_add_ps(_mm256_set1_ps(spanCross[0]), _mm256_mul_ps(laneOffsets, _mm256_set1_ps(setup.stepX[0])));
+			const __m256 cross1 = _mm256_add_ps(_mm256_set1_ps(spanCross[1]), _mm256_mul_ps(laneOffsets, _mm256_set1_ps(setup.stepX[1])));
+			const __m256 cross2 = _mm256_add_ps(_mm256_set1_ps(spanCross[2]), _mm256_mul_ps(laneOffsets, _mm256_set1_ps(setup.stepX[2])));
+
+			__mmask8 inside = _mm256_mask_cmp_ps_mask(__mmask8(laneMask), cross0, zero, _CMP_GE_OQ);
+			inside = _mm256_mask_cmp_ps_mask(inside, cross1, zero, _CMP_GE_OQ);
+			inside = _mm256_mask_cmp_ps_mask(inside, cross2, zero, _CMP_GE_OQ);
+
+			span.insideMask = uint32_t(inside);
+
+			if (inside == 0)
+			{
+				return 0;
+			}
+
+			const __m256 weightV0 = _mm256_mul_ps(cross0, invTotalArea);
+			const __m256 weightV1 = _mm256_mul_ps(cross1, invTotalArea);
+			const __m256 weightV2 = _mm256_sub_ps(_mm256_sub_ps(one, weightV0), weightV1);
+
+			// z / w is linear in raster space
+			const __m256 zBuffer = _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_set1_ps(setup.depth[0]), weightV0),
+				_mm256_mul_ps(_mm256_set1_ps(setup.depth[1]), weightV1)),
+				_mm256_mul_ps(_mm256_set1_ps(setup.depth[2]), weightV2));
+
+			inside = _mm256_mask_cmp_ps_mask(inside, zBuffer, zero, _CMP_GE_OQ);
+			inside = _mm256_mask_cmp_ps_mask(inside, zBuffer, one, _CMP_LE_OQ);
+			inside = _mm256_mask_cmp_ps_mask(inside, zBuffer, _mm256_loadu_ps(pDepth), _CMP_LT_OQ);
+
+			_mm256_storeu_ps(span.weights[0], weightV0);
+			_mm256_storeu_ps(span.weights[1], weightV1);
+			_mm256_storeu_ps(span.weights[2], weightV2);
+			_mm256_storeu_ps(span.depth, zBuffer);
+
+			return uint32_t(inside);
+		}
+
+		void TransformVerticesAVX512(const VertexTransformSetup& setup, const VertexInputStreams& input, const VertexOutputStreams& output, size_t begin, size_t end)
+		{
+			// Sixteen vertices per iteration, every register holds one component of each of them
+			const float* matrix = setup.worldViewProjection;
+			const float* world = setup.world;
+
+			const __m512 one = _mm512_set1_ps(1.0f);
+			const __m512 half = _mm512_set1_ps(0.5f);
+			const __m512 width = _mm512_set1_ps(setup.width);
+			const __m512 height = _mm512_set1_ps(setup.height);
+
+			// Row-major matrix times (x, y, z, w), one output component
+			const auto transform = [](const float* pMatrix, int component, __m512 x, __m512 y, __m512 z)
+				{
+					return _mm512_add_ps(_mm512_add_ps(
+						_mm512_mul_ps(_mm512_set1_ps(pMatrix[component]), x),
+						_mm512_mul_ps(_mm512_set1_ps(pMatrix[4 + component]), y)),
+						_mm512_mul_ps(_mm512_set1_ps(pMatrix[8 + component]), z));
+				};
+
+			size_t index{ begin };
+
+			for (; index + 16 <= end; index += 16)
+			{
+				const __m512 x = _mm512_loadu_ps(input.position[0] + index);
+				const __m512 y = _mm512_loadu_ps(input.position[1] + index);
+				const __m512 z = _mm512_loadu_ps(input.position[2] + index);
+
+				__m512 clip[4];
+
+				for (int component{ 0 }; component < 4; ++component)
+				{
+					clip[component] = _mm512_add_ps(transform(matrix, component, x, y, z), _mm512_set1_ps(matrix[12 + component]));
+					_mm512_storeu_ps(output.clip[component] + index, clip[component]);
+				}
+
+				_mm512_storeu_ps(output.raster[0] + index, _mm512_mul_ps(_mm512_mul_ps(_mm512_add_ps(_mm512_div_ps(clip[0], clip[3]), one), half), width));
+				_mm512_storeu_ps(output.raster[1] + index, _mm512_mul_ps(_mm512_mul_ps(_mm512_sub_ps(one, _mm512_div_ps(clip[1], clip[3])), half), height));
+				_mm512_storeu_ps(output.raster[2] + index, _mm512_div_ps(clip[2], clip[3]));
+
+				_mm512_storeu_ps(output.uv[0] + index, _mm512_loadu_ps(input.uv[0] + index));
+				_mm512_storeu_ps(output.uv[1] + index, _mm512_loadu_ps(input.uv[1] + index));
+
+				const __m512 normalX = _mm512_loadu_ps(input.normal[0] + index);
+				const __m512 normalY = _mm512_loadu_ps(input.normal[1] + index);
+				const __m512 normalZ = _mm512_loadu_ps(input.normal[2] + index);
+
+				const __m512 tangentX = _mm512_loadu_ps(input.tangent[0] + index);
+				const __m512 tangentY = _mm512_loadu_ps(input.tangent[1] + index);
+				const __m512 tangentZ = _mm512_loadu_ps(input.tangent[2] + index);
+
+				__m512 toCamera[3];
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					_mm512_storeu_ps(output.normal[axis] + index, transform(world, axis, normalX, normalY, normalZ));
+					_mm512_storeu_ps(output.tangent[axis] + index, transform(world, axis, tangentX, tangentY, tangentZ));
+
+					toCamera[axis] = _mm512_sub_ps(_mm512_set1_ps(setup.cameraOrigin[axis]), _mm512_add_ps(transform(world, axis, x, y, z), _mm512_set1_ps(world[12 + axis])));
+				}
+
+				// Zero-masked with every lane set, the same vsqrtps without the undefined source GCC warns about in _mm512_sqrt_ps
+				const __m512 distance = _mm512_maskz_sqrt_ps(__mmask16(0xffff), _mm512_add_ps(_mm512_add_ps(
+					_mm512_mul_ps(toCamera[0], toCamera[0]),
+					_mm512_mul_ps(toCamera[1], toCamera[1])),
+					_mm512_mul_ps(toCamera[2], toCamera[2])));
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					_mm512_storeu_ps(output.viewDirection[axis] + index, _mm512_div_ps(toCamera[axis], distance));
+				}
+			}
+
+			TransformVerticesSSE(setup, input, output, index, end);
+		}
+	}
+}
@@ -7,206 +7,958 @@
 
 #include <iostream>
 #include <algorithm>
+#include <bit>
+#include <chrono>
 #include <execution>
 
 #include "Maths.h"
 #include "Texture.h"
+#include "MeshCache.h"
+#include "Profiler.h"
 #include "Utils.h"
 
 using namespace dae;
 
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	float ToMilliseconds(Clock::duration duration)
+	{
+		return std::chrono::duration<float, std::milli>(duration).count();
+	}
+}
+
 Renderer::Renderer(SDL_Window* pWindow) :
 	m_pWindow(pWindow)
 {
-	//Initialize
-	SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+	SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+
+	//Create Buffers
+	m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
+	m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
+	m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
+
+	const SDL_PixelFormat* pFormat = m_pBackBuffer->format;
+	m_PixelFormat = PixelFormat{ pFormat->Rshift, pFormat->Gshift, pFormat->Bshift, pFormat->Amask };
+
+	Initialize();
+}
+
+Renderer::Renderer(int width, int height) :
+	m_Width(width),
+	m_Height(height)
+{
+	m_HeadlessBackBuffer.resize(size_t(m_Width) * m_Height);
+	m_pBackBufferPixels = m_HeadlessBackBuffer.data();
+
+	Initialize();
+}
+
+Renderer::~Renderer()
+{
+	SDL_FreeSurface(m_pBackBuffer);
+}
+
+void Renderer::Initialize()
+{
+	m_Kernels = RasterKernels::GetKernelTable(CpuFeatures::GetInstructionSet());
+
+	m_DepthBuffer.assign(size_t(m_Width) * m_Height, FLT_MAX);
+
+	m_HiZWidth = (m_Width + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE;
+	m_HiZHeight = (m_Height + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE;
+	m_HiZBuffer.resize(size_t(m_HiZWidth) * m_HiZHeight);
+
+	m_VisibilityBuffer.resize(size_t(m_Width) * m_Height);
+	m_OverdrawBuffer.resize(size_t(m_Width) * m_Height);
+
+	{
+		// The separate maps are only needed to build the material
+		const std::unique_ptr<Texture> pDiffuseMap = Texture::LoadFromFile("resources/vehicle_diffuse.png");
+		const std::unique_ptr<Texture> pNormalMap = Texture::LoadFromFile("resources/vehicle_normal.png");
+		const std::unique_ptr<Texture> pSpecularMap = Texture::LoadFromFile("resources/vehicle_specular.png");
+		const std::unique_ptr<Texture> pGlossMap = Texture::LoadFromFile("resources/vehicle_gloss.png");
+
+		if (pDiffuseMap && pNormalMap && pSpecularMap && pGlossMap)
+		{
+			m_Material = MaterialTexture::Create(*pDiffuseMap, *pNormalMap, *pSpecularMap, *pGlossMap);
+		}
+
+		// Every shading mode reads the material, so a missing or mismatched map falls back to a flat one instead
+		if (!m_Material)
+		{
+			std::cout << "The vehicle maps are missing or differ in size, shading with a flat material" << std::endl;
+			m_Material = MaterialTexture::CreateFlat();
+		}
+	}
+
+	m_Shininess = 25.0f;
+	m_Kd = 7.0f;
+	m_Ks = 0.5f;
+	m_LightDirection = { 0.577f, -0.577f, 0.577f };
+	m_Ambience = { .025f,.025f,.025f };
+
+	// The gloss map scales the shininess by at most one
+	m_PhongPow = PowPolynomial{ m_Shininess, PowPolynomial::SPECULAR_MAX_ERROR };
+
+	LoadMesh("resources/vehicle.obj");
+
+	//Initialize Camera
+	m_Camera.Initialize(45.f, { .0f, 5.f, -64.f });
+	m_Camera.aspectRatio = static_cast<float>(m_Width) / static_cast<float>(m_Height);
+
+	//Split the screen in tiles, each tile owns its part of the buffers
+	m_ScreenTile = Tile{ 0, 0, m_Width, m_Height };
+
+	for (int tileY{ 0 }; tileY < m_Height; tileY += TILE_SIZE)
+	{
+		for (int tileX{ 0 }; tileX < m_Width; tileX += TILE_SIZE)
+		{
+			m_Tiles.push_back(Tile{ tileX, tileY, std::min(tileX + TILE_SIZE, m_Width), std::min(tileY + TILE_SIZE, m_Height) });
+		}
+	}
+}
+
+bool Renderer::LoadMesh(const std::string& filename)
+{
+	Mesh& mesh = m_WorldMeshes[0];
+
+	Utils::ObjStatistics objStatistics{};
+
+	if (!Utils::LoadCachedOBJ(filename, mesh.vertices, mesh.indices, true, &objStatistics))
+	{
+		std::cout << filename << " could not be read" << std::endl;
+		return false;
+	}
+
+	std::cout << filename << (objStatistics.isFromCache ? " (cached): " : ": ") << objStatistics.faceCorners << " face corners share " << objStatistics.uniqueVertices << " vertices ("
+		<< float(objStatistics.faceCorners) / std::max(objStatistics.uniqueVertices, 1u) << "x fewer to transform)" << std::endl;
+	mesh.bounds = Utils::CalculateBoundingBox(mesh.vertices);
+	mesh.vertexBuffer.Assign(mesh.vertices);
+
+	return true;
+}
+
+void Renderer::SetInstructionSet(InstructionSet instructionSet)
+{
+	m_Kernels = RasterKernels::GetKernelTable(instructionSet);
+}
+
+const uint32_t* Renderer::GetBackBufferPixels() const
+{
+	return m_pBackBufferPixels;
+}
+
+const float* Renderer::GetDepthBuffer() const
+{
+	return m_DepthBuffer.data();
+}
+
+void Renderer::Update(Timer* pTimer)
+{
+	m_Camera.Update(pTimer);
+
+	if (m_RotationOn)
+	{
+		yaw = 1.0f * pTimer->GetElapsed();
+		const Matrix rotationMatrix = Matrix::CreateRotationY(yaw);
+		m_WorldMeshes[0].worldMatrix *= rotationMatrix;
+		m_MeshYaw += yaw;
+	}
+}
+
+void Renderer::SetPose(const CameraKeyframe& pose)
+{
+	m_Camera.SetPose(pose.origin, pose.pitch, pose.yaw);
+
+	m_MeshYaw = pose.meshYaw;
+	m_WorldMeshes[0].worldMatrix = Matrix::CreateRotationY(pose.meshYaw);
+}
+
+CameraKeyframe Renderer::GetPose() const
+{
+	return CameraKeyframe{ 0.0f, m_Camera.origin, m_Camera.totalPitch, m_Camera.totalYaw, m_MeshYaw };
+}
+
+float Renderer::Remap(float depthValue, float min, float max)
+{
+	return (std::max(depthValue, min) - min) / (max - min);
+}
+
+void Renderer::Render()
+{
+	//@START
+	PROFILE_SCOPE("Frame");
+
+	const Clock::time_point frameStart = Clock::now();
+
+	{
+		PROFILE_SCOPE("Clear");
+
+		//Lock BackBuffer
+		if (m_pWindow)
+		{
+			SDL_LockSurface(m_pBackBuffer);
+		}
+
+		std::fill_n(m_pBackBufferPixels, m_Width * m_Height, PackPixel(128, 128, 128));
+
+		std::fill(m_DepthBuffer.begin(), m_DepthBuffer.end(), FLT_MAX);
+		std::fill(m_HiZBuffer.begin(), m_HiZBuffer.end(), FLT_MAX);
+
+		if (m_VisibilityBufferOn)
+		{
+			std::fill(m_VisibilityBuffer.begin(), m_VisibilityBuffer.end(), INVALID_TRIANGLE);
+		}
+
+		if (m_OverdrawView)
+		{
+			std::fill(m_OverdrawBuffer.begin(), m_OverdrawBuffer.end(), uint8_t{ 0 });
+		}
+
+		m_Triangles.clear();
+		m_ScreenTile.statistics = {};
+
+		for (Tile& tile : m_Tiles)
+		{
+			tile.statistics = {};
+		}
+	}
+
+	const Clock::time_point clearEnd = Clock::now();
+
+	const Matrix projectionMatrix = Matrix::CreatePerspectiveFovLH(m_Camera.fov, m_Camera.aspectRatio, m_Camera.near, m_Camera.far);
+
+	for (size_t index{ 0 }; index < m_WorldMeshes.size(); ++index)
+	{
+		Mesh& mesh = m_WorldMeshes[index];
+
+		const Matrix worldViewProjectionMatrix = mesh.worldMatrix * m_Camera.viewMatrix * projectionMatrix;
+
+		// Checked before transforming anything, a mesh out of view costs six plane tests
+		if (!IsInsideFrustum(mesh.bounds, worldViewProjectionMatrix))
+		{
+			mesh.vertices_out.Clear();
+
+			++m_ScreenTile.statistics.culledMeshes;
+			continue;
+		}
+
+		VertexTransformationFunction(mesh.vertexBuffer, mesh.vertices_out, mesh.worldMatrix, worldViewProjectionMatrix);
+
+		AssembleTriangles(static_cast<uint32_t>(index));
+	}
+
+	m_ScreenTile.statistics.assembledTriangles = static_cast<uint32_t>(m_Triangles.size());
+
+	// The shading options can only change between frames
+	const ShaderFunctions shader = SelectShaderFunctions();
+
+	const Clock::time_point geometryEnd = Clock::now();
+	Clock::time_point binningEnd = geometryEnd;
+
+	if (m_MultithreadingOn)
+	{
+		// Sort-middle: every tile rasterizes the triangles touching it, tiles never share pixels so no locking is needed
+		BinTriangles();
+
+		binningEnd = Clock::now();
+
+		std::for_each(std::execution::par, m_Tiles.begin(), m_Tiles.end(), [this, &shader](Tile& tile)
+			{
+				RasterizeTile(tile, shader);
+			});
+	}
+	else
+	{
+		for (uint32_t index{ 0 }; index < m_Triangles.size(); ++index)
+		{
+			const Triangle& triangle = m_Triangles[index];
+
+			(this->*shader.renderTriangle)(GetVertex(triangle, 0), GetVertex(triangle, 1), GetVertex(triangle, 2), index, m_ScreenTile);
+		}
+
+		(this->*shader.flushFragments)(m_ScreenTile);
+
+		if (m_OverdrawView)
+		{
+			WriteOverdrawHeatMap(m_ScreenTile);
+		}
+		else if (m_VisibilityBufferOn)
+		{
+			(this->*shader.resolveVisibilityBuffer)(m_ScreenTile);
+		}
+	}
+
+	const Clock::time_point rasterEnd = Clock::now();
+
+	m_Statistics = m_ScreenTile.statistics;
+
+	for (const Tile& tile : m_Tiles)
+	{
+		m_Statistics += tile.statistics;
+	}
+
+	//@END
+	//Update SDL Surface
+	if (m_pWindow)
+	{
+		PROFILE_SCOPE("Present");
+
+		SDL_UnlockSurface(m_pBackBuffer);
+		SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
+		SDL_UpdateWindowSurface(m_pWindow);
+	}
+
+	const Clock::time_point frameEnd = Clock::now();
+
+	m_StageTimings.clear = ToMilliseconds(clearEnd - frameStart);
+	m_StageTimings.geometry = ToMilliseconds(geometryEnd - clearEnd);
+	m_StageTimings.binning = ToMilliseconds(binningEnd - geometryEnd);
+	m_StageTimings.raster = ToMilliseconds(rasterEnd - binningEnd);
+	m_StageTimings.present = ToMilliseconds(frameEnd - rasterEnd);
+}
+
+bool Renderer::IsInsideFrustum(const BoundingBox& bounds, const Matrix& worldViewProjectionMatrix)
+{
+	// Clip space x, y, z and w are the dot products of the point with the columns of the matrix
+	// So the frustum planes in object space are sums of columns, a point is inside when its dot product is not negative
+	Vector4 columns[4]{};
+
+	for (int column{ 0 }; column < 4; ++column)
+	{
+		columns[column] = Vector4{ worldViewProjectionMatrix[0][column], worldViewProjectionMatrix[1][column], worldViewProjectionMatrix[2][column], worldViewProjectionMatrix[3][column] };
+	}
+
+	const Vector4 planes[6]
+	{
+		columns[3] + columns[0],
+		columns[3] - columns[0],
+		columns[3] + columns[1],
+		columns[3] - columns[1],
+		columns[2],
+		columns[3] - columns[2]
+	};
+
+	for (const Vector4& plane : planes)
+	{
+		// The corner furthest along the normal of the plane, if even that one is behind it the whole box is
+		const Vector4 corner
+		{
+			plane.x >= 0 ? bounds.maximum.x : bounds.minimum.x,
+			plane.y >= 0 ? bounds.maximum.y : bounds.minimum.y,
+			plane.z >= 0 ? bounds.maximum.z : bounds.minimum.z,
+			1
+		};
+
+		if (Vector4::Dot(plane, corner) < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Renderer::AssembleTriangles(uint32_t meshIndex)
+{
+	PROFILE_SCOPE("AssembleTriangles");
+
+	size_t index0{};
+	size_t index1{};
+	size_t index2{};
+
+	const auto& mesh = m_WorldMeshes[meshIndex];
+	const auto& indices = mesh.indices;
+
+	for (size_t newIndex{ 0 }; newIndex < indices.size();)
+	{
+		if (mesh.primitiveTopology == PrimitiveTopology::TriangleStrip)
+		{
+			if (newIndex + 2 >= indices.size())
+			{
+				break;
+			}
+
+			if (newIndex % 2 == 0)
+			{
+				index0 = indices[newIndex];
+				index1 = indices[newIndex + 1];
+				index2 = indices[newIndex + 2];
+			}
+			else
+			{
+				index0 = indices[newIndex];
+				index1 = indices[newIndex + 2];
+				index2 = indices[newIndex + 1];
+			}
+
+			++newIndex;
+		}
+		else // PrimitiveTopology::TriangleList
+		{
+			if (newIndex + 2 >= indices.size())
+			{
+				break;
+			}
+
+			index0 = indices[newIndex];
+			index1 = indices[newIndex + 1];
+			index2 = indices[newIndex + 2];
+
+			newIndex += 3;
+		}
+
+		const uint32_t vertexIndices[3]{ uint32_t(index0), uint32_t(index1), uint32_t(index2) };
+
+		++m_ScreenTile.statistics.submittedTriangles;
+		ClipTriangle(meshIndex, vertexIndices);
+	}
+}
+
+void Renderer::ClipTriangle(uint32_t meshIndex, const uint32_t vertexIndices[3])
+{
+	// Planes in clip space as (a, b, c, d), a point is inside when a * x + b * y + c * z + d * w >= 0
+	// Near and far, the sides of the view frustum and the sides of the guard band
+	static constexpr int PLANE_COUNT{ 10 };
+	static constexpr float planes[PLANE_COUNT][4]
+	{
+		{ 0, 0, 1, 0 }, { 0, 0, -1, 1 },
+		{ 1, 0, 0, 1 }, { -1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 0, -1, 0, 1 },
+		{ 1, 0, 0, GUARD_BAND }, { -1, 0, 0, GUARD_BAND }, { 0, 1, 0, GUARD_BAND }, { 0, -1, 0, GUARD_BAND }
+	};
+
+	static constexpr uint32_t DEPTH_PLANES{ 0b0000000011 };
+	static constexpr uint32_t FRUSTUM_PLANES{ 0b0000111111 };
+	static constexpr uint32_t CLIPPING_PLANES{ 0b1111000011 };
+
+	const auto getDistance = [](int plane, const Vector4& point)
+		{
+			return planes[plane][0] * point.x + planes[plane][1] * point.y + planes[plane][2] * point.z + planes[plane][3] * point.w;
+		};
+
+	Mesh& mesh = m_WorldMeshes[meshIndex];
+
+	uint32_t outsideAll{ ~0u };
+	uint32_t outsideAny{ 0 };
+
+	for (int corner{ 0 }; corner < 3; ++corner)
+	{
+		uint32_t outside{ 0 };
+
+		for (int plane{ 0 }; plane < PLANE_COUNT; ++plane)
+		{
+			if (getDistance(plane, mesh.vertices_out.GetClipPosition(vertexIndices[corner])) < 0)
+			{
+				outside |= 1u << plane;
+			}
+		}
+
+		outsideAll &= outside;
+		outsideAny |= outside;
+	}
+
+	// Every corner lies behind the same plane of the view frustum, nothing of it can be seen
+	if (outsideAll & DEPTH_PLANES)
+	{
+		++m_ScreenTile.statistics.depthRangeTriangles;
+		return;
+	}
+
+	if (outsideAll & FRUSTUM_PLANES)
+	{
+		++m_ScreenTile.statistics.outsideTriangles;
+		return;
+	}
+
+	// Crossing the sides of the screen is left to the bounding box, so most triangles go through untouched
+	if (!(outsideAny & CLIPPING_PLANES))
+	{
+		CullTriangle(meshIndex, vertexIndices[0], vertexIndices[1], vertexIndices[2]);
+		return;
+	}
+
+	// Sutherland-Hodgman in clip space, where the attributes are still linear, every plane adds at most one corner
+	static constexpr int MAX_CORNERS{ 3 + PLANE_COUNT };
+
+	++m_ScreenTile.statistics.clippedTriangles;
+
+	std::array<Vertex_Out, MAX_CORNERS> polygon{};
+	int cornerCount{ 3 };
+
+	for (int corner{ 0 }; corner < 3; ++corner)
+	{
+		polygon[corner] = mesh.vertices_out.GetVertex(vertexIndices[corner]);
+		polygon[corner].position = mesh.vertices_out.GetClipPosition(vertexIndices[corner]);
+	}
+
+	for (int plane{ 0 }; plane < PLANE_COUNT; ++plane)
+	{
+		if (!(outsideAny & CLIPPING_PLANES & (1u << plane)))
+		{
+			continue;
+		}
+
+		std::array<Vertex_Out, MAX_CORNERS> clipped{};
+		int clippedCount{ 0 };
+
+		for (int corner{ 0 }; corner < cornerCount; ++corner)
+		{
+			const Vertex_Out& current = polygon[corner];
+			const Vertex_Out& next = polygon[(corner + 1) % cornerCount];
+
+			const float currentDistance = getDistance(plane, current.position);
+			const float nextDistance = getDistance(plane, next.position);
+
+			if (currentDistance >= 0)
+			{
+				clipped[clippedCount++] = current;
+			}
+
+			if ((currentDistance >= 0) != (nextDistance >= 0))
+			{
+				clipped[clippedCount++] = LerpVertex(current, next, currentDistance / (currentDistance - nextDistance));
+			}
+		}
+
+		polygon = clipped;
+		cornerCount = clippedCount;
+
+		if (cornerCount < 3)
+		{
+			return;
+		}
+	}
+
+	// The new corners are appended to the transformed vertices of the mesh, they are thrown away again next frame
+	const uint32_t firstIndex = uint32_t(mesh.vertices_out.Size());
+
+	for (int corner{ 0 }; corner < cornerCount; ++corner)
+	{
+		const Vector4 clipPosition = polygon[corner].position;
+
+		polygon[corner].position = ClipToRaster(clipPosition);
+		mesh.vertices_out.PushBack(clipPosition, polygon[corner]);
+	}
+
+	// Fanning out from the first corner keeps the winding of the original triangle
+	for (int corner{ 1 }; corner + 1 < cornerCount; ++corner)
+	{
+		CullTriangle(meshIndex, firstIndex, firstIndex + corner, firstIndex + corner + 1);
+	}
+}
+
+void Renderer::CullTriangle(uint32_t meshIndex, uint32_t index0, uint32_t index1, uint32_t index2)
+{
+	const Mesh& mesh = m_WorldMeshes[meshIndex];
+
+	const float* rasterX = mesh.vertices_out.raster[0].data();
+	const float* rasterY = mesh.vertices_out.raster[1].data();
+
+	// Same sign as the total area in RenderTriangle, positive when the triangle faces the camera
+	const float signedArea = Vector2::Cross(
+		Vector2{ rasterX[index1] - rasterX[index0], rasterY[index1] - rasterY[index0] },
+		Vector2{ rasterX[index2] - rasterX[index0], rasterY[index2] - rasterY[index0] });
+	const bool isFrontFacing = signedArea > 0;
+
+	// Assembly runs before the tiles are handed out, so its work is counted with the screen tile
+	if (signedArea == 0)
+	{
+		++m_ScreenTile.statistics.degenerateTriangles;
+		return;
+	}
+
+	if ((mesh.cullMode == CullMode::Back && !isFrontFacing) ||
+		(mesh.cullMode == CullMode::Front && isFrontFacing))
+	{
+		++m_ScreenTile.statistics.culledTriangles;
+		return;
+	}
+
+	// RenderTriangle only fills front faces, so the winding of a visible back face gets flipped
+	if (!isFrontFacing)
+	{
+		std::swap(index1, index2);
+	}
+
+	m_Triangles.push_back(Triangle{ meshIndex, { index0, index1, index2 } });
+}
+
+void Renderer::BinTriangles()
+{
+	PROFILE_SCOPE("BinTriangles");
+
+	const int tilesPerRow = (m_Width + TILE_SIZE - 1) / TILE_SIZE;
+
+	for (Tile& tile : m_Tiles)
+	{
+		tile.triangleIndices.clear();
+	}
+
+	for (size_t index{ 0 }; index < m_Triangles.size(); ++index)
+	{
+		const Triangle& triangle = m_Triangles[index];
+		const TransformedVertexBuffer& verticesOut = m_WorldMeshes[triangle.meshIndex].vertices_out;
+
+		const Vector2 p0{ verticesOut.raster[0][triangle.vertexIndices[0]], verticesOut.raster[1][triangle.vertexIndices[0]] };
+		const Vector2 p1{ verticesOut.raster[0][triangle.vertexIndices[1]], verticesOut.raster[1][triangle.vertexIndices[1]] };
+		const Vector2 p2{ verticesOut.raster[0][triangle.vertexIndices[2]], verticesOut.raster[1][triangle.vertexIndices[2]] };
+
+		// Same bounding box as RenderTriangle, so a triangle ends up in every tile it can write to
+		const int minX = int(std::max(0.0f, std::min(std::min(std::min(p0.x, p1.x), p2.x), float(m_Width - 1))));
+		const int minY = int(std::max(0.0f, std::min(std::min(std::min(p0.y, p1.y), p2.y), float(m_Height - 1))));
+		const int maxX = int(std::max(0.0f, std::min(std::ceil(std::max(std::max(p0.x, p1.x), p2.x)), float(m_Width - 1))));
+		const int maxY = int(std::max(0.0f, std::min(std::ceil(std::max(std::max(p0.y, p1.y), p2.y)), float(m_Height - 1))));
+
+		if (minX >= maxX || minY >= maxY)
+		{
+			continue;
+		}
+
+		for (int tileY{ minY / TILE_SIZE }; tileY <= (maxY - 1) / TILE_SIZE; ++tileY)
+		{
+			for (int tileX{ minX / TILE_SIZE }; tileX <= (maxX - 1) / TILE_SIZE; ++tileX)
+			{
+				m_Tiles[tileX + tileY * tilesPerRow].triangleIndices.push_back(uint32_t(index));
+			}
+		}
+	}
+}
+
+void Renderer::RasterizeTile(Tile& tile, const ShaderFunctions& shader)
+{
+	PROFILE_SCOPE("RasterizeTile");
+
+	for (const uint32_t triangleIndex : tile.triangleIndices)
+	{
+		const Triangle& triangle = m_Triangles[triangleIndex];
+
+		(this->*shader.renderTriangle)(GetVertex(triangle, 0), GetVertex(triangle, 1), GetVertex(triangle, 2), triangleIndex, tile);
+	}
+
+	(this->*shader.flushFragments)(tile);
+
+	if (m_OverdrawView)
+	{
+		WriteOverdrawHeatMap(tile);
+	}
+	else if (m_VisibilityBufferOn)
+	{
+		(this->*shader.resolveVisibilityBuffer)(tile);
+	}
+}
+
+Renderer::ShaderFunctions Renderer::SelectShaderFunctions() const
+{
+	// The depth view ignores all other options
+	if (m_OverdrawView)
+	{
+		return GetShaderFunctions<ShaderVariant{ ShadingMode::Combined, false, false, true }>();
+	}
+
+	if (m_DepthBufferView)
+	{
+		return GetShaderFunctions<ShaderVariant{ ShadingMode::Combined, false, true }>();
+	}
+
+	switch (m_ShadingMode)
+	{
+	case ShadingMode::ObservedArea:
+		return SelectShaderFunctions<ShadingMode::ObservedArea>(m_NormalMapOn);
+	case ShadingMode::Diffuse:
+		return SelectShaderFunctions<ShadingMode::Diffuse>(m_NormalMapOn);
+	case ShadingMode::Specular:
+		return SelectShaderFunctions<ShadingMode::Specular>(m_NormalMapOn);
+	case ShadingMode::Combined:
+	default:
+		return SelectShaderFunctions<ShadingMode::Combined>(m_NormalMapOn);
+	}
+}
+
+template<Renderer::ShadingMode Mode>
+Renderer::ShaderFunctions Renderer::SelectShaderFunctions(bool isNormalMapOn)
+{
+	if (isNormalMapOn)
+	{
+		return GetShaderFunctions<ShaderVariant{ Mode, true, false }>();
+	}
+
+	return GetShaderFunctions<ShaderVariant{ Mode, false, false }>();
+}
+
+template<Renderer::ShaderVariant Variant>
+Renderer::ShaderFunctions Renderer::GetShaderFunctions()
+{
+	return ShaderFunctions{ &Renderer::RenderTriangle<Variant>, &Renderer::ResolveVisibilityBuffer<Variant>, &Renderer::FlushFragments<Variant> };
+}
+
+template<Renderer::ShaderVariant Variant>
+void Renderer::ResolveVisibilityBuffer(Tile& tile)
+{
+	PROFILE_SCOPE("ResolveVisibilityBuffer");
 
-	//Create Buffers
-	m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
-	m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-	m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
+	// Neighbouring pixels mostly show the same triangle, so its setup is only redone when that changes
+	uint32_t setupTriangleIndex{ INVALID_TRIANGLE };
+	InterpolationSetup interpolationSetup{};
 
-	m_pDepthBufferPixels = new float[m_Width * m_Height];
+	Vector2 V0{};
+	Vector2 V1{};
+	Vector2 V2{};
+	float invTotalArea{};
 
-	std::fill_n(m_pDepthBufferPixels, m_Width * m_Height, FLT_MAX);
+	for (int py{ tile.minY }; py < tile.maxY; ++py)
+	{
+		for (int px{ tile.minX }; px < tile.maxX; ++px)
+		{
+			const int pixelIndex = px + (py * m_Width);
+			const uint32_t triangleIndex = m_VisibilityBuffer[pixelIndex];
 
-	m_Texture = Texture::LoadFromFile("resources/vehicle_diffuse.png");
-	m_NormalMap = Texture::LoadFromFile("resources/vehicle_normal.png");
-	m_SpecularMap = Texture::LoadFromFile("resources/vehicle_specular.png");
-	m_GlossMap = Texture::LoadFromFile("resources/vehicle_gloss.png");
+			if (triangleIndex == INVALID_TRIANGLE) continue;
 
-	m_Shininess = 25.0f;
-	m_Kd = 7.0f;
-	m_Ks = 0.5f;
-	m_LightDirection = { 0.577f, -0.577f, 0.577f };
-	m_Ambience = { .025f,.025f,.025f };
+			if (triangleIndex != setupTriangleIndex)
+			{
+				const Triangle& triangle = m_Triangles[triangleIndex];
 
-	Utils::ParseOBJ("resources/vehicle.obj", m_WorldMeshes[0].vertices, m_WorldMeshes[0].indices);
+				const Vertex_Out firstVertex = GetVertex(triangle, 0);
+				const Vertex_Out secondVertex = GetVertex(triangle, 1);
+				const Vertex_Out thirdVertex = GetVertex(triangle, 2);
 
-	//Initialize Camera
-	m_Camera.Initialize(45.f, { .0f, 5.f, -64.f });
-	m_Camera.aspectRatio = static_cast<float>(m_Width) / static_cast<float>(m_Height);
+				interpolationSetup = CreateInterpolationSetup(firstVertex, secondVertex, thirdVertex);
+
+				V0 = Vector2{ firstVertex.position.x, firstVertex.position.y };
+				V1 = Vector2{ secondVertex.position.x, secondVertex.position.y };
+				V2 = Vector2{ thirdVertex.position.x, thirdVertex.position.y };
+				invTotalArea = 1 / Vector2::Cross(V1 - V0, V2 - V0);
+
+				setupTriangleIndex = triangleIndex;
+			}
+
+			// Reconstructing the weights from the stored triangle
+			const Vector2 currentPixel{ px + 0.5f, py + 0.5f };
+
+			const float weightV0 = Vector2::Cross(V2 - V1, currentPixel - V1) * invTotalArea;
+			const float weightV1 = Vector2::Cross(V0 - V2, currentPixel - V2) * invTotalArea;
+			const float weightV2 = 1 - weightV0 - weightV1;
+
+			WriteFragment<Variant>(tile, pixelIndex, ShadeFragment<Variant>(interpolationSetup, weightV0, weightV1, weightV2, m_DepthBuffer[pixelIndex]));
+
+			++tile.statistics.shadedFragments;
+			++tile.statistics.coveredPixels;
+		}
+	}
+
+	FlushFragments<Variant>(tile);
 }
 
-Renderer::~Renderer()
+void Renderer::WriteOverdrawHeatMap(Tile& tile)
+{
+	for (int py{ tile.minY }; py < tile.maxY; ++py)
+	{
+		for (int px{ tile.minX }; px < tile.maxX; ++px)
+		{
+			const int pixelIndex = px + (py * m_Width);
+			const uint8_t fragmentCount = m_OverdrawBuffer[pixelIndex];
+
+			if (fragmentCount == 0) continue;
+
+			WritePixel(pixelIndex, GetHeatColor(fragmentCount));
+
+			++tile.statistics.coveredPixels;
+		}
+	}
+}
+
+ColorRGB Renderer::GetHeatColor(uint32_t fragmentCount)
 {
-	delete[] m_pDepthBufferPixels;
+	// One color per fragment count, from blue for a pixel written once to red for eight times or more
+	static constexpr int HEAT_STEP_COUNT{ 8 };
+	static constexpr ColorRGB heatColors[HEAT_STEP_COUNT]
+	{
+		{ 0.0f, 0.0f, 0.5f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.6f, 1.0f }, { 0.0f, 1.0f, 0.5f },
+		{ 0.5f, 1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 1.0f, 0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f }
+	};
+
+	return heatColors[std::min(fragmentCount, uint32_t(HEAT_STEP_COUNT)) - 1];
 }
 
-void Renderer::Update(Timer* pTimer)
+Vertex_Out Renderer::GetVertex(const Triangle& triangle, int corner) const
 {
-	m_Camera.Update(pTimer);
+	return m_WorldMeshes[triangle.meshIndex].vertices_out.GetVertex(triangle.vertexIndices[corner]);
+}
 
-	if (m_RotationOn)
+Vector4 Renderer::ClipToRaster(const Vector4& clipPosition) const
+{
+	return Vector4
 	{
-		yaw = 1.0f * pTimer->GetElapsed();
-		const Matrix rotationMatrix = Matrix::CreateRotationY(yaw);
-		m_WorldMeshes[0].worldMatrix *= rotationMatrix;
-	}
+		(clipPosition.x / clipPosition.w + 1) * 0.5f * float(m_Width),
+		(-(clipPosition.y / clipPosition.w) + 1) * 0.5f * float(m_Height),
+		clipPosition.z / clipPosition.w,
+		clipPosition.w
+	};
 }
 
-float Renderer::Remap(float depthValue, float min, float max)
+Vertex_Out Renderer::LerpVertex(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, float factor)
 {
-	return (std::max(depthValue, min) - min) / (max - min);
+	// Only what TransformedVertexBuffer keeps, the color is left at its default since no shading mode reads it
+	Vertex_Out vertex{};
+	vertex.position = firstVertex.position + (secondVertex.position - firstVertex.position) * factor;
+	vertex.uv = firstVertex.uv + (secondVertex.uv - firstVertex.uv) * factor;
+	vertex.normal = firstVertex.normal + (secondVertex.normal - firstVertex.normal) * factor;
+	vertex.tangent = firstVertex.tangent + (secondVertex.tangent - firstVertex.tangent) * factor;
+	vertex.viewDirection = firstVertex.viewDirection + (secondVertex.viewDirection - firstVertex.viewDirection) * factor;
+
+	return vertex;
 }
 
-void Renderer::Render()
+Renderer::InterpolationSetup Renderer::CreateInterpolationSetup(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, const Vertex_Out& thirdVertex)
 {
-	//@START
-	//Lock BackBuffer
-	SDL_LockSurface(m_pBackBuffer);
+	InterpolationSetup setup{};
+
+	const Vertex_Out* vertices[3]{ &firstVertex, &secondVertex, &thirdVertex };
 
-	Uint32 clearColor = SDL_MapRGB(m_pBackBuffer->format, 128, 128, 128);
-	SDL_FillRect(m_pBackBuffer, nullptr, clearColor);
+	// Weight i is the edge function opposite to vertex i over the total area, so it changes linearly in raster space
+	const Vector2 V0{ firstVertex.position.x, firstVertex.position.y };
+	const Vector2 V1{ secondVertex.position.x, secondVertex.position.y };
+	const Vector2 V2{ thirdVertex.position.x, thirdVertex.position.y };
 
-	std::fill_n(m_pDepthBufferPixels, m_Width * m_Height, FLT_MAX);
+	const float invTotalArea = 1 / Vector2::Cross(V1 - V0, V2 - V0);
+	const Vector2 edges[3]{ V2 - V1, V0 - V2, V1 - V0 };
 
-	for (size_t index{ 0 }; index < m_WorldMeshes.size(); ++index)
+	for (int corner{ 0 }; corner < 3; ++corner)
 	{
-		m_WorldMeshes[index].vertices_out.reserve(m_WorldMeshes[index].vertices.size());
+		const float invW = 1 / vertices[corner]->position.w;
+
+		setup.weightStepX[corner] = -edges[corner].y * invTotalArea;
+		setup.weightStepY[corner] = edges[corner].x * invTotalArea;
+		setup.invW[corner] = invW;
+		setup.uv[corner] = vertices[corner]->uv * invW;
+		setup.normal[corner] = vertices[corner]->normal * invW;
+		setup.tangent[corner] = vertices[corner]->tangent * invW;
+		setup.viewDirection[corner] = vertices[corner]->viewDirection * invW;
+	}
+
+	return setup;
+}
 
-		VertexTransformationFunction(m_WorldMeshes[index].vertices, m_WorldMeshes[index].vertices_out);
+template<Renderer::ShaderVariant Variant>
+Renderer::ShadedFragment Renderer::ShadeFragment(const InterpolationSetup& setup, float weightV0, float weightV1, float weightV2, float depth) const
+{
+	if constexpr (Variant.isDepthView)
+	{
+		const float colorValue = Remap(depth, 0.995f, 1.0f);
 
-		Vertex_Out firstVertex;
-		Vertex_Out secondVertex;
-		Vertex_Out thirdVertex;
+		return ShadedFragment{ ColorRGB{ colorValue, colorValue, colorValue } };
+	}
+	else
+	{
+		const float interInvW = setup.invW[0] * weightV0 + setup.invW[1] * weightV1 + setup.invW[2] * weightV2;
+		const float interWDepth = 1 / interInvW;
 
-		size_t index0;
-		size_t index1;
-		size_t index2;
+		// Attributes the variant does not read are left at zero
+		Vertex_Out pixelVertexData{};
+		Vector2 uvDdx{};
+		Vector2 uvDdy{};
 
-		const auto& mesh = m_WorldMeshes[index];
-		const auto& indices = mesh.indices;
-		const auto& verticesOut = mesh.vertices_out;
+		pixelVertexData.normal = (setup.normal[0] * weightV0 + setup.normal[1] * weightV1 + setup.normal[2] * weightV2) * interWDepth;
 
-		for (size_t newIndex{ 0 }; newIndex < indices.size();)
+		if constexpr (Variant.UsesMaterial())
 		{
-			if (mesh.primitiveTopology == PrimitiveTopology::TriangleStrip)
-			{
-				if (newIndex + 2 >= indices.size())
-				{
-					break;
-				}
+			const Vector2 interUVOverW = setup.uv[0] * weightV0 + setup.uv[1] * weightV1 + setup.uv[2] * weightV2;
+			const Vector2 interUV = interUVOverW * interWDepth;
 
-				if (newIndex % 2 == 0)
-				{
-					index0 = indices[newIndex];
-					index1 = indices[newIndex + 1];
-					index2 = indices[newIndex + 2];
-				}
-				else
+			// Same as the differences within a 2x2 quad, the uv of the neighbouring pixels follows from stepping the weights
+			const auto getNeighbourUV = [&setup, &interInvW, &interUVOverW](const float weightStep[3])
 				{
-					index0 = indices[newIndex];
-					index1 = indices[newIndex + 2];
-					index2 = indices[newIndex + 1];
-				}
+					const float invW = interInvW + setup.invW[0] * weightStep[0] + setup.invW[1] * weightStep[1] + setup.invW[2] * weightStep[2];
+					const Vector2 uvOverW = interUVOverW + setup.uv[0] * weightStep[0] + setup.uv[1] * weightStep[1] + setup.uv[2] * weightStep[2];
 
-				firstVertex = verticesOut[index0];
-				secondVertex = verticesOut[index1];
-				thirdVertex = verticesOut[index2];
+					return uvOverW / invW;
+				};
 
-				++newIndex;
-			}
-			else if (mesh.primitiveTopology == PrimitiveTopology::TriangleList)
-			{
-				if (newIndex + 2 >= indices.size())
-				{
-					break;
-				}
+			pixelVertexData.uv = interUV;
+			uvDdx = getNeighbourUV(setup.weightStepX) - interUV;
+			uvDdy = getNeighbourUV(setup.weightStepY) - interUV;
+		}
 
-				index0 = indices[newIndex];
-				index1 = indices[newIndex + 1];
-				index2 = indices[newIndex + 2];
+		if constexpr (Variant.isNormalMapOn)
+		{
+			pixelVertexData.tangent = (setup.tangent[0] * weightV0 + setup.tangent[1] * weightV1 + setup.tangent[2] * weightV2) * interWDepth;
+		}
 
-				firstVertex = verticesOut[index0];
-				secondVertex = verticesOut[index1];
-				thirdVertex = verticesOut[index2];
+		if constexpr (Variant.UsesViewDirection())
+		{
+			pixelVertexData.viewDirection = (setup.viewDirection[0] * weightV0 + setup.viewDirection[1] * weightV1 + setup.viewDirection[2] * weightV2) * interWDepth;
+		}
 
-				newIndex += 3;
-			}
+		return PixelShading<Variant>(pixelVertexData, uvDdx, uvDdy);
+	}
+}
 
-			// If the z component is further than far and smaller than near - skip the current calculation
-			if (!(firstVertex.position.z > FLT_EPSILON && firstVertex.position.z < 1) || !(secondVertex.position.z > FLT_EPSILON && secondVertex.position.z < 1) || !(thirdVertex.position.z > FLT_EPSILON && thirdVertex.position.z < 1))
-			{
-				continue;
-			}
+void Renderer::WritePixel(int pixelIndex, ColorRGB colour)
+{
+	//Update Color in Buffer
+	colour.MaxToOne();
 
-			RenderTriangle(firstVertex, secondVertex, thirdVertex);
-		}
-	}
+	m_pBackBufferPixels[pixelIndex] = PackPixel(
+		static_cast<uint8_t>(colour.r * 255),
+		static_cast<uint8_t>(colour.g * 255),
+		static_cast<uint8_t>(colour.b * 255));
+}
 
-	//@END
-	//Update SDL Surface
-	SDL_UnlockSurface(m_pBackBuffer);
-	SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
-	SDL_UpdateWindowSurface(m_pWindow);
+uint32_t Renderer::PackPixel(uint8_t red, uint8_t green, uint8_t blue) const
+{
+	// What SDL_MapRGB does for a 32 bit format, without looking the format up for every pixel
+	return (uint32_t(red) << m_PixelFormat.redShift) | (uint32_t(green) << m_PixelFormat.greenShift) | (uint32_t(blue) << m_PixelFormat.blueShift) | m_PixelFormat.alphaMask;
 }
 
-void Renderer::VertexTransformationFunction(const std::vector<Vertex>& vertices_in, std::vector<Vertex_Out>& vertices_out) const
+void Renderer::VertexTransformationFunction(const VertexBuffer& vertices_in, TransformedVertexBuffer& vertices_out, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix) const
 {
-	vertices_out.clear();
-	vertices_out.reserve(vertices_in.size());
+	PROFILE_SCOPE("VertexTransformation");
+
+	vertices_out.Resize(vertices_in.Size());
 
-	const Matrix worldMatrix = m_WorldMeshes[0].worldMatrix;
-	const Matrix megaMatrix = worldMatrix * m_Camera.viewMatrix * Matrix::CreatePerspectiveFovLH(m_Camera.fov, m_Camera.aspectRatio, m_Camera.near, m_Camera.far);
+	VertexTransformSetup setup{};
 
-	for (size_t index{0}; index < vertices_in.size(); ++index)
+	for (int row{ 0 }; row < 4; ++row)
 	{
-		// Step 1. From world to Camera space + Step 3. Projection
-		Vector4 transformedPoint = megaMatrix.TransformPoint(vertices_in[index].position.ToVector4());
-		vertices_out.emplace_back(transformedPoint, vertices_in[index].color, vertices_in[index].uv);
+		for (int column{ 0 }; column < 4; ++column)
+		{
+			setup.worldViewProjection[row * 4 + column] = worldViewProjectionMatrix[row][column];
+			setup.world[row * 4 + column] = worldMatrix[row][column];
+		}
+	}
 
-		// Step 2. Perspective divide
-		vertices_out[index].position.x = vertices_out[index].position.x / vertices_out[index].position.w;
-		vertices_out[index].position.y = vertices_out[index].position.y / vertices_out[index].position.w;
-		vertices_out[index].position.z = vertices_out[index].position.z / vertices_out[index].position.w;
+	setup.cameraOrigin[0] = m_Camera.origin.x;
+	setup.cameraOrigin[1] = m_Camera.origin.y;
+	setup.cameraOrigin[2] = m_Camera.origin.z;
+	setup.width = float(m_Width);
+	setup.height = float(m_Height);
 
-		// Step for additional info calculations
-		vertices_out[index].normal = worldMatrix.TransformVector(vertices_in[index].normal);
-		vertices_out[index].tangent = worldMatrix.TransformVector(vertices_in[index].tangent);
-		vertices_out[index].viewDirection = (m_Camera.origin - worldMatrix.TransformPoint(vertices_in[index].position)).Normalized();
-	}
+	// Steps 1 to 4 and the additional info in a single pass, in the kernel picked for this CPU
+	m_Kernels.transformVertices(setup, vertices_in.GetStreams(), vertices_out.GetStreams(), 0, vertices_in.Size());
+}
+
+template<Renderer::ShaderVariant Variant>
+Renderer::ShadedFragment Renderer::PixelShading(const Vertex_Out& v, const Vector2& uvDdx, const Vector2& uvDdy) const
+{
+	// One fetch for every map of the material
+	MaterialSample material{};
 
-	// Step 4. Converting to Raster Space (Screen Space)
-	for (size_t index{0}; index < vertices_out.size(); ++index)
+	if constexpr (Variant.UsesMaterial())
 	{
-		vertices_out[index].position.x = (vertices_out[index].position.x + 1) * 0.5f * m_Width;
-		vertices_out[index].position.y = (1 - vertices_out[index].position.y) * 0.5f * m_Height;
+		material = m_Material->Sample(v.uv, uvDdx, uvDdy, m_TextureFilter);
 	}
-}
 
-ColorRGB Renderer::PixelShading(const Vertex_Out& v)
-{
 	Vector3 finalNormal;
 
 	// Sampling normal map
-	if (m_NormalMapOn)
+	if constexpr (Variant.isNormalMapOn)
 	{
 		const Vector3 binormal = Vector3::Cross(v.normal, v.tangent);
 		const Matrix tangentToWorldMatrix = Matrix{ v.tangent, binormal, v.normal, Vector3::Zero };
 
-		const ColorRGB normalMapColour = m_NormalMap->Sample(v.uv);
-		Vector3 sampledNormal = Vector3{ normalMapColour.r, normalMapColour.g, normalMapColour.b };
+		Vector3 sampledNormal = Vector3{ material.normal.r, material.normal.g, material.normal.b };
 
 		sampledNormal = 2.0f * sampledNormal - Vector3{ 1.0f, 1.0f, 1.0f };
 		finalNormal = tangentToWorldMatrix.TransformVector(sampledNormal).Normalized();
@@ -216,43 +968,110 @@ ColorRGB Renderer::PixelShading(const Vertex_Out& v)
 		finalNormal = v.normal.Normalized();
 	}
 
-	ColorRGB finalColour;
+	const float observedArea{ std::max(Vector3::Dot(finalNormal, -m_LightDirection), 0.0f) };
+
+	if constexpr (Variant.shadingMode == ShadingMode::ObservedArea)
+	{
+		return ShadedFragment{ ColorRGB{ observedArea, observedArea, observedArea } };
+	}
+	else if constexpr (Variant.shadingMode == ShadingMode::Diffuse)
+	{
+		const ColorRGB lambertDiffuse{ (m_Kd * material.diffuse) / M_PI };
 
-	m_ObservedArea = { std::max(Vector3::Dot(finalNormal, -m_LightDirection), 0.0f) };
+		return ShadedFragment{ lambertDiffuse * observedArea };
+	}
+	else
+	{
+		// Phong, raised to the gloss exponent in WriteFragment
+		const Vector3 reflect = -m_LightDirection - (2.0f * Vector3::Dot(-m_LightDirection, finalNormal) * finalNormal);
+		const float cosa = std::max(0.0f, Vector3::Dot(reflect, -v.viewDirection));
 
-	// Sampling additional info
-	const ColorRGB specularMapColour = m_SpecularMap->Sample(v.uv);
-	const float glossMapValue = m_GlossMap->Sample(v.uv).r;
-	const ColorRGB lambertDiffuse{ (m_Kd * m_Texture->Sample(v.uv)) / M_PI };
+		if constexpr (Variant.shadingMode == ShadingMode::Specular)
+		{
+			return ShadedFragment{ {}, {}, cosa, material.gloss * m_Shininess };
+		}
+		else
+		{
+			const ColorRGB lambertDiffuse{ (m_Kd * material.diffuse) / M_PI };
 
-	// Phong
-	const Vector3 reflect = -m_LightDirection - (2.0f * Vector3::Dot(-m_LightDirection, finalNormal) * finalNormal);
-	const float cosa = std::max(0.0f, Vector3::Dot(reflect, -v.viewDirection));
-	const float phong = m_Ks * std::pow(cosa, glossMapValue * m_Shininess);
+			return ShadedFragment{ lambertDiffuse * observedArea, material.specular, cosa, material.gloss * m_Shininess };
+		}
+	}
+}
 
+template<Renderer::ShaderVariant Variant>
+ColorRGB Renderer::FinishPhong(const ShadedFragment& fragment, float power) const
+{
+	const float phong = m_Ks * power;
 
-	switch (m_ShadingMode)
+	if constexpr (Variant.shadingMode == ShadingMode::Specular)
 	{
-	case ShadingMode::ObservedArea:
-		finalColour = ColorRGB{ m_ObservedArea, m_ObservedArea, m_ObservedArea };
-		break;
-	case ShadingMode::Diffuse:
-		finalColour = lambertDiffuse * m_ObservedArea;
-		break;
-	case ShadingMode::Specular:
-		finalColour = ColorRGB{phong, phong, phong};
-		break;
-	case ShadingMode::Combined:
-		finalColour = (lambertDiffuse * m_ObservedArea + specularMapColour * phong + m_Ambience );
-		break;
+		return ColorRGB{ phong, phong, phong };
+	}
+	else
+	{
+		return fragment.color + fragment.specular * phong + m_Ambience;
+	}
+}
+
+template<Renderer::ShaderVariant Variant>
+void Renderer::WriteFragment(Tile& tile, int pixelIndex, const ShadedFragment& fragment)
+{
+	if constexpr (Variant.UsesPhong())
+	{
+		if (!m_FastPhongOn)
+		{
+			WritePixel(pixelIndex, FinishPhong<Variant>(fragment, std::pow(fragment.cosa, fragment.glossExponent)));
+			return;
+		}
+
+		tile.queuedPixelIndices[tile.queuedCount] = pixelIndex;
+		tile.queuedFragments[tile.queuedCount] = fragment;
+
+		if (++tile.queuedCount == RasterKernels::SPAN_WIDTH)
+		{
+			FlushFragments<Variant>(tile);
+		}
+	}
+	else
+	{
+		WritePixel(pixelIndex, fragment.color);
+	}
+}
+
+template<Renderer::ShaderVariant Variant>
+void Renderer::FlushFragments(Tile& tile)
+{
+	if constexpr (Variant.UsesPhong())
+	{
+		// The lanes past the queued fragments stay at pow(0, 0)
+		float cosa[RasterKernels::SPAN_WIDTH]{};
+		float glossExponent[RasterKernels::SPAN_WIDTH]{};
+		float power[RasterKernels::SPAN_WIDTH];
+
+		for (int lane{ 0 }; lane < tile.queuedCount; ++lane)
+		{
+			cosa[lane] = tile.queuedFragments[lane].cosa;
+			glossExponent[lane] = tile.queuedFragments[lane].glossExponent;
+		}
+
+		m_PhongPow.Pow(cosa, glossExponent, power);
+
+		for (int lane{ 0 }; lane < tile.queuedCount; ++lane)
+		{
+			WritePixel(tile.queuedPixelIndices[lane], FinishPhong<Variant>(tile.queuedFragments[lane], power[lane]));
+		}
 	}
 
-	return finalColour;
+	tile.queuedCount = 0;
 }
 
 
-void Renderer::RenderTriangle(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, const Vertex_Out& thirdVertex)
+template<Renderer::ShaderVariant Variant>
+void Renderer::RenderTriangle(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, const Vertex_Out& thirdVertex, uint32_t triangleIndex, Tile& tile)
 {
+	PROFILE_SCOPE("RenderTriangle");
+
 	// Calculating the bounds
 
 	const Vector2 V0{ firstVertex.position.x, firstVertex.position.y };
@@ -261,6 +1080,16 @@ void Renderer::RenderTriangle(const Vertex_Out& firstVertex, const Vertex_Out& s
 
 	if (V0 == V1 || V1 == V2 || V2 == V0)
 	{
+		++tile.statistics.degenerateTriangles;
+		return;
+	}
+
+	// The three edge functions always add up to the total area, so none of the pixels can pass if it is not positive
+	const float totalArea = Vector2::Cross(V1 - V0, V2 - V0);
+
+	if (totalArea <= 0.0f)
+	{
+		++tile.statistics.degenerateTriangles;
 		return;
 	}
 
@@ -270,111 +1099,228 @@ void Renderer::RenderTriangle(const Vertex_Out& firstVertex, const Vertex_Out& s
 	const float stepMaxX = std::max(firstVertex.position.x, secondVertex.position.x);
 	const float stepMaxY = std::max(firstVertex.position.y, secondVertex.position.y);
 
-	// Bounding box coordinates
-	Vector2 topLeft
+	// Bounding box coordinates, does not exceed the screen (Pixels are not floats) nor the tile
+	const int minX = std::max(int(std::max(0.0f, std::min(std::min(stepMinX, thirdVertex.position.x), float(m_Width - 1)))), tile.minX);
+	const int minY = std::max(int(std::max(0.0f, std::min(std::min(stepMinY, thirdVertex.position.y), float(m_Height - 1)))), tile.minY);
+
+	const int maxX = std::min(int(std::max(0.0f, std::min(std::ceil(std::max(stepMaxX, thirdVertex.position.x)), float(m_Width - 1)))), tile.maxX);
+	const int maxY = std::min(int(std::max(0.0f, std::min(std::ceil(std::max(stepMaxY, thirdVertex.position.y)), float(m_Height - 1)))), tile.maxY);
+
+	if (minX >= maxX || minY >= maxY)
+	{
+		return;
+	}
+
+	// Edge equations, set up once per triangle, edge i lies opposite to vertex i
+	// Cross(Vb - Va, P - Va) grows by -(Vb - Va).y for every step to the right and by (Vb - Va).x for every step down
+	const Vector2 edgeV0 = V2 - V1;
+	const Vector2 edgeV1 = V0 - V2;
+	const Vector2 edgeV2 = V1 - V0;
+
+	// Spans start on a multiple of the span width, the lanes left of the bounding box are masked out
+	const int spanMinX = minX - minX % RasterKernels::SPAN_WIDTH;
+	const Vector2 startPixel{ spanMinX + 0.5f, minY + 0.5f };
+
+	float rowCross[3]
+	{
+		Vector2::Cross(edgeV0, startPixel - V1),
+		Vector2::Cross(edgeV1, startPixel - V2),
+		Vector2::Cross(edgeV2, startPixel - V0)
+	};
+
+	const EdgeSetup edgeSetup
 	{
-		std::min(stepMinX, thirdVertex.position.x),
-		std::min(stepMinY, thirdVertex.position.y)
+		{ -edgeV0.y, -edgeV1.y, -edgeV2.y },
+		1 / totalArea,
+		{ firstVertex.position.z, secondVertex.position.z, thirdVertex.position.z }
 	};
 
-	Vector2 botRight
+	const float spanStepX[3]
 	{
-		std::ceil(std::max(stepMaxX, thirdVertex.position.x)),
-		std::ceil(std::max(stepMaxY, thirdVertex.position.y))
+		edgeSetup.stepX[0] * RasterKernels::SPAN_WIDTH,
+		edgeSetup.stepX[1] * RasterKernels::SPAN_WIDTH,
+		edgeSetup.stepX[2] * RasterKernels::SPAN_WIDTH
 	};
 
-	// Does not exceed screen (Pixels are not floats)
-	topLeft.x = int(std::max(0.0f, std::min(topLeft.x, float(m_Width - 1))));
-	topLeft.y = int(std::max(0.0f, std::min(topLeft.y, float(m_Height - 1))));
+	const RasterKernels::CoverageSpanFunction coverageSpan = m_SimdRasterOn ? m_Kernels.coverageSpan : RasterKernels::CoverageSpanScalar;
 
-	botRight.x = int(std::max(0.0f, std::min(botRight.x, float(m_Width - 1))));
-	botRight.y = int(std::max(0.0f, std::min(botRight.y, float(m_Height - 1))));
+	// Per vertex terms hoisted out of the pixel loop
+	const InterpolationSetup interpolationSetup = CreateInterpolationSetup(firstVertex, secondVertex, thirdVertex);
 
+	// The nearest depth of the triangle, blocks that already hold only closer pixels can be skipped
+	const float minDepth = std::min(std::min(firstVertex.position.z, secondVertex.position.z), thirdVertex.position.z);
 
-	// Actual render of the triangle
+	const int minBlockX = spanMinX / HIZ_BLOCK_SIZE;
+	const int minBlockY = minY / HIZ_BLOCK_SIZE;
+	const int maxBlockX = (maxX - 1) / HIZ_BLOCK_SIZE;
+	const int maxBlockY = (maxY - 1) / HIZ_BLOCK_SIZE;
 
-	for (int px{ int(topLeft.x) }; px < int(botRight.x); ++px)
+	if (m_HiZOn)
 	{
-		for (int py{ int(topLeft.y) }; py < int(botRight.y); ++py)
-		{
-			Vector2 currentPixel{ px + 0.5f, py + 0.5f };
+		bool isVisible{ false };
 
-			Vector2 eVector = V1 - V0;
-			Vector2 pVector = currentPixel - V0;
+		for (int blockY{ minBlockY }; blockY <= maxBlockY && !isVisible; ++blockY)
+		{
+			for (int blockX{ minBlockX }; blockX <= maxBlockX && !isVisible; ++blockX)
+			{
+				isVisible = minDepth < m_HiZBuffer[blockX + blockY * m_HiZWidth];
+			}
+		}
 
-			const float cross1 = Vector2::Cross(eVector, pVector);
+		if (!isVisible)
+		{
+			++tile.statistics.rejectedTriangles;
+			return;
+		}
+	}
 
-			if (cross1 < 0.0f) continue;
+	// Actual render of the triangle, block by block and row by row inside a block so the buffers are walked linearly
 
-			eVector = V2 - V1;
-			pVector = currentPixel - V1;
+	PixelSpan span{};
 
-			const float cross2 = Vector2::Cross(eVector, pVector);
+	for (int blockY{ minBlockY }; blockY <= maxBlockY; ++blockY)
+	{
+		const int firstRow = std::max(blockY * HIZ_BLOCK_SIZE, minY);
+		const int lastRow = std::min((blockY + 1) * HIZ_BLOCK_SIZE, maxY);
 
-			if (cross2 < 0.0f) continue;
+		float blockCross[3]{ rowCross[0], rowCross[1], rowCross[2] };
 
-			eVector = V0 - V2;
-			pVector = currentPixel - V2;
+		for (int blockX{ minBlockX }; blockX <= maxBlockX; ++blockX, blockCross[0] += spanStepX[0], blockCross[1] += spanStepX[1], blockCross[2] += spanStepX[2])
+		{
+			float& blockMaxDepth = m_HiZBuffer[blockX + blockY * m_HiZWidth];
 
-			const float cross3 = Vector2::Cross(eVector, pVector);
+			if (m_HiZOn && minDepth >= blockMaxDepth)
+			{
+				++tile.statistics.rejectedBlocks;
+				continue;
+			}
 
-			if (cross3 < 0.0f) continue;
+			// A block is exactly one span wide
+			const int spanX = blockX * HIZ_BLOCK_SIZE;
+			const int firstLane = std::max(minX - spanX, 0);
+			const int lastLane = std::min(maxX - spanX, RasterKernels::SPAN_WIDTH);
+			const uint32_t laneMask = ((1u << lastLane) - 1) & ~((1u << firstLane) - 1);
+			const int laneCount = lastLane - firstLane;
 
-			// Calculating weights
-			const float totalArea = Vector2::Cross(V1 - V0, V2 - V0);
+			float spanCross[3]{ blockCross[0], blockCross[1], blockCross[2] };
+			bool isBlockWritten{ false };
 
-			const float weightV0 = cross2 / totalArea;
-			const float weightV1 = cross3 / totalArea;
-			const float weightV2 = 1 - weightV0 - weightV1;
+			for (int py{ firstRow }; py < lastRow; ++py, spanCross[0] += edgeV0.x, spanCross[1] += edgeV1.x, spanCross[2] += edgeV2.x)
+			{
+				const int rowIndex = py * m_Width;
 
-			// Calculating the interpolated depth
-			const float zBuffer = 1 / (1 / firstVertex.position.z * weightV0 + 1 / secondVertex.position.z * weightV1 + 1 / thirdVertex.position.z * weightV2);
+				// The last span of a row can stick out of the screen, the kernel always reads a full span of depth
+				float spanDepth[RasterKernels::SPAN_WIDTH];
+				const float* pDepth = m_DepthBuffer.data() + rowIndex + spanX;
 
-			if (zBuffer < 0) continue;
-			if (zBuffer > 1) continue;
+				if (spanX + RasterKernels::SPAN_WIDTH > m_Width)
+				{
+					std::fill_n(spanDepth, RasterKernels::SPAN_WIDTH, FLT_MAX);
+					std::copy_n(pDepth, m_Width - spanX, spanDepth);
+					pDepth = spanDepth;
+				}
 
-			if (zBuffer < m_pDepthBufferPixels[px + (py * m_Width)])
-			{
-				m_pDepthBufferPixels[px + (py * m_Width)] = zBuffer;
+				uint32_t coverageMask = coverageSpan(edgeSetup, spanCross, pDepth, laneMask, span);
 
-				const float interWDepth = 1 / (1 / firstVertex.position.w * weightV0 + 1 / secondVertex.position.w * weightV1 + 1 / thirdVertex.position.w * weightV2);
+				tile.statistics.testedPixels += laneCount;
+				tile.statistics.coveragePasses += std::popcount(span.insideMask);
+				tile.statistics.depthPasses += std::popcount(coverageMask);
 
-				ColorRGB finalColour;
+				isBlockWritten = isBlockWritten || coverageMask != 0;
 
-				if (!m_DepthBufferView)
+				while (coverageMask != 0)
 				{
-					const Vector2 interUV = (firstVertex.uv / firstVertex.position.w * weightV0 + secondVertex.uv / secondVertex.position.w * weightV1 + thirdVertex.uv / thirdVertex.position.w * weightV2) * interWDepth;
-					const Vector3 normal = Vector3(firstVertex.normal / firstVertex.position.w * weightV0 + secondVertex.normal / secondVertex.position.w * weightV1 + thirdVertex.normal / thirdVertex.position.w * weightV2) * interWDepth;
-					const Vector3 tangent = Vector3(firstVertex.tangent / firstVertex.position.w * weightV0 + secondVertex.tangent / secondVertex.position.w * weightV1 + thirdVertex.tangent / thirdVertex.position.w * weightV2) * interWDepth;
-					const Vector3 viewDir = (firstVertex.viewDirection / firstVertex.position.w * weightV0 + secondVertex.viewDirection / secondVertex.position.w * weightV1 + thirdVertex.viewDirection / thirdVertex.position.w * weightV2) * interWDepth;
+					const int lane = std::countr_zero(coverageMask);
+					coverageMask &= coverageMask - 1;
 
-					const Vertex_Out pixelVertexData{ {}, {}, interUV, normal, tangent, viewDir };
+					const float zBuffer = span.depth[lane];
+					const int pixelIndex = rowIndex + spanX + lane;
 
-					finalColour = PixelShading(pixelVertexData);
-				}
-				else
-				{
-					const float colorValue = Remap(zBuffer, 0.995f, 1.0f);
+					// Only count the fragment, the counts are turned into colors once all triangles are in
+					if constexpr (Variant.isOverdrawView)
+					{
+						m_DepthBuffer[pixelIndex] = zBuffer;
 
-					finalColour = ColorRGB{ colorValue, colorValue, colorValue };
-				}
+						uint8_t& fragmentCount = m_OverdrawBuffer[pixelIndex];
+						fragmentCount += fragmentCount < UINT8_MAX;
+						continue;
+					}
+
+					// Only remember which triangle is visible, it is shaded once all triangles are in
+					if (m_VisibilityBufferOn)
+					{
+						m_DepthBuffer[pixelIndex] = zBuffer;
+						m_VisibilityBuffer[pixelIndex] = triangleIndex;
+						continue;
+					}
 
-				//Update Color in Buffer
-				finalColour.MaxToOne();
+					if (m_DepthBuffer[pixelIndex] == FLT_MAX)
+					{
+						++tile.statistics.coveredPixels;
+					}
 
-				m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-					static_cast<uint8_t>(finalColour.r * 255),
-					static_cast<uint8_t>(finalColour.g * 255),
-					static_cast<uint8_t>(finalColour.b * 255));
+					m_DepthBuffer[pixelIndex] = zBuffer;
+
+					WriteFragment<Variant>(tile, pixelIndex, ShadeFragment<Variant>(interpolationSetup, span.weights[0][lane], span.weights[1][lane], span.weights[2][lane], zBuffer));
+
+					++tile.statistics.shadedFragments;
+				}
+			}
+
+			// Depths only ever get closer, so the block maximum has to be refreshed after a write
+			if (m_HiZOn && isBlockWritten)
+			{
+				blockMaxDepth = CalculateBlockMaxDepth(blockX, blockY);
 			}
 		}
+
+		const float rowCount = float(lastRow - firstRow);
+
+		rowCross[0] += edgeV0.x * rowCount;
+		rowCross[1] += edgeV1.x * rowCount;
+		rowCross[2] += edgeV2.x * rowCount;
 	}
 }
 
+float Renderer::CalculateBlockMaxDepth(int blockX, int blockY) const
+{
+	const int minX = blockX * HIZ_BLOCK_SIZE;
+	const int minY = blockY * HIZ_BLOCK_SIZE;
+	const int maxX = std::min(minX + HIZ_BLOCK_SIZE, m_Width);
+	const int maxY = std::min(minY + HIZ_BLOCK_SIZE, m_Height);
+
+	float maxDepth{ 0.0f };
+
+	for (int py{ minY }; py < maxY; ++py)
+	{
+		const float* pDepthRow = m_DepthBuffer.data() + py * m_Width;
+
+		maxDepth = std::max(maxDepth, *std::max_element(pDepthRow + minX, pDepthRow + maxX));
+	}
+
+	return maxDepth;
+}
+
 
 bool Renderer::SaveBufferToImage() const
 {
-	return SDL_SaveBMP(m_pBackBuffer, "Rasterizer_ColorBuffer.bmp");
+	if (m_pBackBuffer)
+	{
+		return SDL_SaveBMP(m_pBackBuffer, "Rasterizer_ColorBuffer.bmp");
+	}
+
+	// Headless the pixels are only wrapped for saving, surfaces work without the video subsystem
+	SDL_Surface* pSurface = SDL_CreateRGBSurfaceWithFormatFrom(m_pBackBufferPixels, m_Width, m_Height, 32, m_Width * int(sizeof(uint32_t)), SDL_PIXELFORMAT_RGB888);
+
+	if (!pSurface)
+	{
+		return true;
+	}
+
+	const bool isFailed = SDL_SaveBMP(pSurface, "Rasterizer_ColorBuffer.bmp");
+	SDL_FreeSurface(pSurface);
+
+	return isFailed;
 }
 
 void Renderer::ToggleRotation()
@@ -390,6 +1336,13 @@ void Renderer::ToggleNormals()
 void Renderer::ToggleDepthBuffer()
 {
 	m_DepthBufferView = !m_DepthBufferView;
+	m_OverdrawView = false;
+}
+
+void Renderer::ToggleOverdrawView()
+{
+	m_OverdrawView = !m_OverdrawView;
+	m_DepthBufferView = false;
 }
 
 void Renderer::ToggleShadowMode()
@@ -411,6 +1364,74 @@ void Renderer::ToggleShadowMode()
 	}
 }
 
+void Renderer::ToggleMultithreading()
+{
+	m_MultithreadingOn = !m_MultithreadingOn;
+}
+
+void Renderer::ToggleSimdRasterization()
+{
+	m_SimdRasterOn = !m_SimdRasterOn;
+}
+
+void Renderer::ToggleHiZ()
+{
+	m_HiZOn = !m_HiZOn;
+}
+
+void Renderer::ToggleVisibilityBuffer()
+{
+	m_VisibilityBufferOn = !m_VisibilityBufferOn;
+}
+
+void Renderer::ToggleTextureFilter()
+{
+	switch (m_TextureFilter)
+	{
+	case TextureFilter::Trilinear:
+		m_TextureFilter = TextureFilter::Nearest;
+		break;
+	case TextureFilter::Nearest:
+		m_TextureFilter = TextureFilter::Bilinear;
+		break;
+	case TextureFilter::Bilinear:
+		m_TextureFilter = TextureFilter::Trilinear;
+		break;
+	}
+}
+
+void Renderer::ToggleFastPhong()
+{
+	m_FastPhongOn = !m_FastPhongOn;
+}
 
+Renderer::RenderStatistics& Renderer::RenderStatistics::operator+=(const RenderStatistics& other)
+{
+	submittedTriangles += other.submittedTriangles;
+	culledMeshes += other.culledMeshes;
+	depthRangeTriangles += other.depthRangeTriangles;
+	outsideTriangles += other.outsideTriangles;
+	clippedTriangles += other.clippedTriangles;
+	assembledTriangles += other.assembledTriangles;
+	culledTriangles += other.culledTriangles;
+	degenerateTriangles += other.degenerateTriangles;
+	rejectedTriangles += other.rejectedTriangles;
+	rejectedBlocks += other.rejectedBlocks;
+	testedPixels += other.testedPixels;
+	coveragePasses += other.coveragePasses;
+	depthPasses += other.depthPasses;
+	shadedFragments += other.shadedFragments;
+	coveredPixels += other.coveredPixels;
+
+	return *this;
+}
 
+const Renderer::RenderStatistics& Renderer::GetStatistics() const
+{
+	return m_Statistics;
+}
 
+const Renderer::StageTimings& Renderer::GetStageTimings() const
+{
+	return m_StageTimings;
+}
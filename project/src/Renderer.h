@@ -4,9 +4,16 @@
 #include <vector>
 #include <array>
 #include <memory>
+#include <string>
 
+#include "AlignedAllocator.h"
 #include "Camera.h"
+#include "CameraPath.h"
 #include "DataTypes.h"
+#include "RasterKernels.h"
+#include "MaterialTexture.h"
+#include "PowPolynomial.h"
+#include "Texture.h"
 
 namespace dae
 {
@@ -28,6 +35,8 @@ namespace dae
 	{
 	public:
 		Renderer(SDL_Window* pWindow);
+		// Renders into its own buffers, no window or SDL video subsystem needed
+		Renderer(int width, int height);
 		~Renderer();
 
 		Renderer(const Renderer&) = delete;
@@ -38,17 +47,136 @@ namespace dae
 		void Update(Timer* pTimer);
 		void Render();
 
+		// Places the camera and turns the mesh from a keyframe instead of input and the timer, for reproducible runs
+		void SetPose(const CameraKeyframe& pose);
+		CameraKeyframe GetPose() const;
+
 		bool SaveBufferToImage() const;
 
-		void VertexTransformationFunction(const std::vector<Vertex>& vertices_in, std::vector<Vertex_Out>& vertices_out) const;
-		ColorRGB PixelShading(const Vertex_Out& v);
+		// Replaces the vehicle with another OBJ, returns false when the file can not be read
+		bool LoadMesh(const std::string& filename);
+
+		// The raster kernels start out as the ones CpuFeatures selected, this swaps them for those of another instruction set
+		void SetInstructionSet(InstructionSet instructionSet);
+
+		// The buffers of the last frame, width times height values row by row
+		const uint32_t* GetBackBufferPixels() const;
+		const float* GetDepthBuffer() const;
+
+		// Work done and skipped during the last frame
+		// Every tile counts its own work, owned by one worker at a time, and the tiles are summed once the frame is done
+		// Triangles that reach the raster stage are counted once for every tile they touch
+		struct RenderStatistics
+		{
+			// Triangles read from the index buffers of the meshes inside the view frustum
+			uint32_t submittedTriangles{};
+
+			// Meshes outside the view frustum
+			uint32_t culledMeshes{};
+
+			// Triangles rejected by the z-range check, every corner in front of the near or behind the far plane
+			uint32_t depthRangeTriangles{};
+
+			// Triangles with every corner beyond the same side plane of the view frustum
+			uint32_t outsideTriangles{};
+
+			// Triangles crossing the near or far plane or the guard band, before they are cut up
+			uint32_t clippedTriangles{};
+
+			// Triangles handed to the raster stage after culling and clipping, every piece of a clipped triangle counts
+			uint32_t assembledTriangles{};
+
+			// Triangles facing the culled side of their mesh and triangles without area on screen
+			uint32_t culledTriangles{};
+			uint32_t degenerateTriangles{};
+
+			// Skipped thanks to the hierarchical depth buffer
+			uint32_t rejectedTriangles{};
+			uint32_t rejectedBlocks{};
+
+			// Pixels of the bounding boxes run through the edge tests, those inside the edges and those that also pass the depth test
+			uint32_t testedPixels{};
+			uint32_t coveragePasses{};
+			uint32_t depthPasses{};
+
+			// Shaded fragments over covered pixels is the overdraw the shading pays for
+			uint32_t shadedFragments{};
+			uint32_t coveredPixels{};
+
+			RenderStatistics& operator+=(const RenderStatistics& other);
+		};
+
+		// Wall time in milliseconds of the stages of the last frame
+		struct StageTimings
+		{
+			float clear{};
+			// Vertex transform, culling, clipping and triangle setup
+			float geometry{};
+			// Only done with multithreading, single threaded every triangle goes straight to the raster stage
+			float binning{};
+			// Rasterization and shading, including the visibility buffer resolve
+			float raster{};
+			// Gathering the statistics and copying to the window
+			float present{};
+		};
+
+		// A shaded fragment short of its Phong term, which PowPolynomial raises for a span's worth of fragments at once
+		struct ShadedFragment
+		{
+			ColorRGB color{};
+			ColorRGB specular{};
+			float cosa{};
+			float glossExponent{};
+		};
+
+		// Screen region whose slice of the depth and back buffer is owned by a single worker
+		struct Tile
+		{
+			int minX{};
+			int minY{};
+			int maxX{};
+			int maxY{};
+
+			std::vector<uint32_t> triangleIndices{};
+			RenderStatistics statistics{};
+
+			// Fragments waiting for their Phong term, across triangles since a single one rarely fills a span
+			// Written in the order they came in, so a later fragment of the same pixel still ends up on top
+			ShadedFragment queuedFragments[RasterKernels::SPAN_WIDTH]{};
+			int queuedPixelIndices[RasterKernels::SPAN_WIDTH]{};
+			int queuedCount{};
+		};
+
+		// Vertex attributes of a triangle divided by w, ready for perspective correct interpolation
+		// Along with how much the weights change for one pixel to the right and one pixel down, for the texture derivatives
+		struct InterpolationSetup
+		{
+			float weightStepX[3]{};
+			float weightStepY[3]{};
+			float invW[3]{};
+			Vector2 uv[3]{};
+			Vector3 normal[3]{};
+			Vector3 tangent[3]{};
+			Vector3 viewDirection[3]{};
+		};
+
+		void VertexTransformationFunction(const VertexBuffer& vertices_in, TransformedVertexBuffer& vertices_out, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix) const;
 		static float Remap(float depthValue, float min, float max);
-		void RenderTriangle(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, const Vertex_Out& thirdVertex);
 
 		void ToggleRotation();
 		void ToggleNormals();
 		void ToggleDepthBuffer();
+		void ToggleOverdrawView();
 		void ToggleShadowMode();
+		void ToggleMultithreading();
+		void ToggleSimdRasterization();
+		void ToggleHiZ();
+		void ToggleVisibilityBuffer();
+		void ToggleTextureFilter();
+		void ToggleFastPhong();
+
+		const RenderStatistics& GetStatistics() const;
+		const StageTimings& GetStageTimings() const;
 
 		enum class ShadingMode
 		{
@@ -61,34 +189,106 @@ namespace dae
 		float yaw{};
 
 	private:
+		// The shading options as template argument, every combination gets its own raster and shade loop
+		// So a mode only runs the interpolation, sampling and lighting that ends up in its output
+		struct ShaderVariant
+		{
+			ShadingMode shadingMode{};
+			bool isNormalMapOn{};
+			bool isDepthView{};
+			bool isOverdrawView{};
+
+			constexpr bool UsesMaterial() const
+			{
+				return isNormalMapOn || shadingMode != ShadingMode::ObservedArea;
+			}
+
+			constexpr bool UsesViewDirection() const
+			{
+				return shadingMode == ShadingMode::Specular || shadingMode == ShadingMode::Combined;
+			}
+
+			constexpr bool UsesPhong() const
+			{
+				return UsesViewDirection() && !isDepthView && !isOverdrawView;
+			}
+		};
+
+		// The instantiations for the options of the current frame, picked once before rasterizing
+		struct ShaderFunctions
+		{
+			void (Renderer::*renderTriangle)(const Vertex_Out&, const Vertex_Out&, const Vertex_Out&, uint32_t, Tile&){};
+			void (Renderer::*resolveVisibilityBuffer)(Tile&){};
+			void (Renderer::*flushFragments)(Tile&){};
+		};
+
+		// Where the channels go in a pixel of the back buffer, defaults to the layout SDL picks for a 32 bit surface
+		struct PixelFormat
+		{
+			uint8_t redShift{ 16 };
+			uint8_t greenShift{ 8 };
+			uint8_t blueShift{ 0 };
+			uint32_t alphaMask{};
+		};
+
+		// Only set when presenting to a window, headless the back buffer is m_HeadlessBackBuffer
 		SDL_Window* m_pWindow{};
 
 		SDL_Surface* m_pFrontBuffer{ nullptr };
 		SDL_Surface* m_pBackBuffer{ nullptr };
 		uint32_t* m_pBackBufferPixels{};
+		PixelFormat m_PixelFormat{};
+
+		AlignedVector<uint32_t> m_HeadlessBackBuffer{};
 
-		float* m_pDepthBufferPixels{};
+		AlignedVector<float> m_DepthBuffer{};
+
+		// Maximum depth of every block of the depth buffer
+		static constexpr int HIZ_BLOCK_SIZE{ RasterKernels::SPAN_WIDTH };
+
+		AlignedVector<float> m_HiZBuffer{};
+		int m_HiZWidth{};
+		int m_HiZHeight{};
+
+		// Index in m_Triangles of the triangle visible in every pixel, shaded afterwards in a separate pass
+		static constexpr uint32_t INVALID_TRIANGLE{ UINT32_MAX };
+
+		AlignedVector<uint32_t> m_VisibilityBuffer{};
+
+		// Fragments passing the depth test in every pixel, only filled while the overdraw view is on
+		AlignedVector<uint8_t> m_OverdrawBuffer{};
+
+		RenderStatistics m_Statistics{};
+		StageTimings m_StageTimings{};
 
 		Camera m_Camera{};
 
-		std::unique_ptr<Texture> m_Texture;
-		std::unique_ptr<Texture> m_NormalMap;
-		std::unique_ptr<Texture> m_SpecularMap;
-		std::unique_ptr<Texture> m_GlossMap;
+		// Total rotation of the mesh, kept next to its world matrix for GetPose
+		float m_MeshYaw{};
+
+		RasterKernels::KernelTable m_Kernels{};
+
+		// Diffuse, normal, specular and gloss map interleaved
+		std::unique_ptr<MaterialTexture> m_Material;
 
 		float m_Shininess{};
+
 		float m_Kd{};
 		float m_Ks{};
-		float m_ObservedArea{};
 		Vector3 m_LightDirection{};
 		ColorRGB m_Ambience{};
 
+		// Phong exponentiation of a whole span in one call instead of std::pow per fragment
+		static_assert(PowPolynomial::LANE_COUNT == RasterKernels::SPAN_WIDTH, "The Phong term is exponentiated one span at a time");
+		PowPolynomial m_PhongPow{};
+
 		std::vector<Mesh> m_WorldMeshes{
 			Mesh
 			{
 				{},
 				{},
 				PrimitiveTopology::TriangleList,
+				CullMode::Back,
 				{},
 			}
 		};
@@ -96,12 +296,68 @@ namespace dae
 		int m_Width{};
 		int m_Height{};
 
+		static constexpr int TILE_SIZE{ 64 };
+		static_assert(TILE_SIZE % HIZ_BLOCK_SIZE == 0, "A depth block can not be shared by two tiles");
+
+		// Triangles are only clipped against the sides of the screen once they leave this band, given in multiples of w
+		// Everything in between is handled by clamping the bounding box, which keeps raster positions well within float precision
+		static constexpr float GUARD_BAND{ 16.0f };
+
+		std::vector<Triangle> m_Triangles{};
+		std::vector<Tile> m_Tiles{};
+		Tile m_ScreenTile{};
+
 		bool m_RotationOn{ true };
 		bool m_NormalMapOn{ true };
 		bool m_DepthBufferView{ false };
+		bool m_OverdrawView{ false };
+		bool m_MultithreadingOn{ true };
+		bool m_SimdRasterOn{ true };
+		bool m_HiZOn{ true };
+		bool m_VisibilityBufferOn{ false };
+		bool m_FastPhongOn{ true };
 
 		ShadingMode m_ShadingMode = ShadingMode::Combined;
+		TextureFilter m_TextureFilter = TextureFilter::Trilinear;
+
+		void Initialize();
+
+		static bool IsInsideFrustum(const BoundingBox& bounds, const Matrix& worldViewProjectionMatrix);
+		void AssembleTriangles(uint32_t meshIndex);
+		void ClipTriangle(uint32_t meshIndex, const uint32_t vertexIndices[3]);
+		void CullTriangle(uint32_t meshIndex, uint32_t index0, uint32_t index1, uint32_t index2);
+		void BinTriangles();
+		float CalculateBlockMaxDepth(int blockX, int blockY) const;
+		void RasterizeTile(Tile& tile, const ShaderFunctions& shader);
+
+		ShaderFunctions SelectShaderFunctions() const;
+		template<ShadingMode Mode>
+		static ShaderFunctions SelectShaderFunctions(bool isNormalMapOn);
+		template<ShaderVariant Variant>
+		static ShaderFunctions GetShaderFunctions();
+
+		template<ShaderVariant Variant>
+		void RenderTriangle(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, const Vertex_Out& thirdVertex, uint32_t triangleIndex, Tile& tile);
+		template<ShaderVariant Variant>
+		void ResolveVisibilityBuffer(Tile& tile);
+		void WriteOverdrawHeatMap(Tile& tile);
 
-		//std::vector<Triangle> m_TrianglesToRender{};
+		Vertex_Out GetVertex(const Triangle& triangle, int corner) const;
+		Vector4 ClipToRaster(const Vector4& clipPosition) const;
+		static Vertex_Out LerpVertex(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, float factor);
+		static InterpolationSetup CreateInterpolationSetup(const Vertex_Out& firstVertex, const Vertex_Out& secondVertex, const Vertex_Out& thirdVertex);
+		template<ShaderVariant Variant>
+		ShadedFragment ShadeFragment(const InterpolationSetup& setup, float weightV0, float weightV1, float weightV2, float depth) const;
+		template<ShaderVariant Variant>
+		ShadedFragment PixelShading(const Vertex_Out& v, const Vector2& uvDdx, const Vector2& uvDdy) const;
+		template<ShaderVariant Variant>
+		ColorRGB FinishPhong(const ShadedFragment& fragment, float power) const;
+		template<ShaderVariant Variant>
+		void WriteFragment(Tile& tile, int pixelIndex, const ShadedFragment& fragment);
+		template<ShaderVariant Variant>
+		void FlushFragments(Tile& tile);
+		static ColorRGB GetHeatColor(uint32_t fragmentCount);
+		uint32_t PackPixel(uint8_t red, uint8_t green, uint8_t blue) const;
+		void WritePixel(int pixelIndex, ColorRGB colour);
 	};
 }
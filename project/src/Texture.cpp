@@ -1,51 +1,122 @@
 #include "Texture.h"
-#include "Vector2.h"
 #include <SDL_image.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace dae
 {
-	Texture::Texture(SDL_Surface* pSurface) :
-		m_pSurface{ pSurface },
-		m_pSurfacePixels{ (uint32_t*)pSurface->pixels }
+	namespace
 	{
+		uint32_t PackTexel(int r, int g, int b, int a)
+		{
+			return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+		}
 	}
 
-	Texture::~Texture()
+	// Decodes the surface once, SDL is not needed anymore after this
+	Texture::Texture(SDL_Surface* pSurface, TextureLayout layout)
 	{
-		if (m_pSurface)
+		std::vector<MipLevel> mipLevels{};
+		mipLevels.push_back(MipLevel{ pSurface->w, pSurface->h, 0, std::vector<uint32_t>(size_t(pSurface->w) * pSurface->h) });
+
+		SDL_LockSurface(pSurface);
+
+		// The rows already hold the packed texels, only the pitch can differ
+		for (int y{ 0 }; y < pSurface->h; ++y)
 		{
-			SDL_FreeSurface(m_pSurface);
-			m_pSurface = nullptr;
+			std::memcpy(&mipLevels[0].texels[size_t(y) * pSurface->w], (const Uint8*)pSurface->pixels + y * pSurface->pitch, size_t(pSurface->w) * sizeof(uint32_t));
 		}
+
+		SDL_UnlockSurface(pSurface);
+
+		CreateMipLevels(mipLevels);
+		m_MipChain = MipChain<uint32_t, ColorTexelTraits>{ std::move(mipLevels), layout };
 	}
 
-	std::unique_ptr<Texture> Texture::LoadFromFile(const std::string& path)
+	Texture::~Texture() = default;
+
+	std::unique_ptr<Texture> Texture::LoadFromFile(const std::string& path, TextureLayout layout)
 	{
-		SDL_Surface* pSurface = IMG_Load(path.c_str());
+		SDL_Surface* pLoadedSurface = IMG_Load(path.c_str());
+
+		if (pLoadedSurface == nullptr)
+		{
+			return nullptr;
+		}
+
+		// Palettized, 24 bit and 16 bit images all become four bytes per texel, red first
+		SDL_Surface* pSurface = SDL_ConvertSurfaceFormat(pLoadedSurface, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(pLoadedSurface);
 
 		if (pSurface == nullptr)
 		{
 			return nullptr;
 		}
 
-		return std::unique_ptr<Texture>(new Texture(pSurface));
+		std::unique_ptr<Texture> pTexture{ new Texture(pSurface, layout) };
+		SDL_FreeSurface(pSurface);
+
+		return pTexture;
 	}
 
-	ColorRGB Texture::Sample(const Vector2& uv) const
+	int Texture::GetLevelCount() const
 	{
-		int convertedWidth = int(uv.x * m_pSurface->w);
-		int convertedHeight = int(uv.y * m_pSurface->h);
+		return m_MipChain.GetLevelCount();
+	}
 
-		int indexOfPixel = convertedHeight * m_pSurface->w + convertedWidth;
+	int Texture::GetWidth(int level) const
+	{
+		return m_MipChain.GetWidth(level);
+	}
+
+	int Texture::GetHeight(int level) const
+	{
+		return m_MipChain.GetHeight(level);
+	}
+
+	uint32_t Texture::GetTexel(int level, int x, int y) const
+	{
+		return m_MipChain.GetTexel(level, x, y);
+	}
+
+	void Texture::CreateMipLevels(std::vector<MipLevel>& mipLevels)
+	{
+		while (mipLevels.back().width > 1 || mipLevels.back().height > 1)
+		{
+			const MipLevel& source = mipLevels.back();
 
-		Uint32 pixel = ((Uint32*)m_pSurface->pixels)[indexOfPixel];
+			MipLevel level{ std::max(source.width / 2, 1), std::max(source.height / 2, 1) };
+			level.texels.resize(size_t(level.width) * level.height);
 
-		Uint8 r;
-		Uint8 g;
-		Uint8 b;
+			// Box filter over the 2x2 texels below every new texel, a side of 1 is not halved any further
+			for (int y{ 0 }; y < level.height; ++y)
+			{
+				for (int x{ 0 }; x < level.width; ++x)
+				{
+					int sum[4]{};
 
-		SDL_GetRGB(pixel, m_pSurface->format, &r, &g, &b);
+					for (int offsetY{ 0 }; offsetY < 2; ++offsetY)
+					{
+						for (int offsetX{ 0 }; offsetX < 2; ++offsetX)
+						{
+							const int sourceX = std::min(x * 2 + offsetX, source.width - 1);
+							const int sourceY = std::min(y * 2 + offsetY, source.height - 1);
+							const uint32_t texel = source.texels[size_t(sourceY) * source.width + sourceX];
 
-		return ColorRGB{ r / 255.0f, g / 255.0f, b / 255.0f };
+							for (int channel{ 0 }; channel < 4; ++channel)
+							{
+								sum[channel] += (texel >> (channel * 8)) & 0xff;
+							}
+						}
+					}
+
+					level.texels[size_t(y) * level.width + x] = PackTexel((sum[0] + 2) / 4, (sum[1] + 2) / 4, (sum[2] + 2) / 4, (sum[3] + 2) / 4);
+				}
+			}
+
+			// Pushing can move the source level, so it is not used past this point
+			mipLevels.push_back(std::move(level));
+		}
 	}
-}
\ No newline at end of file
+}
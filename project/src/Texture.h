@@ -1,25 +1,83 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <memory>
-#include <SDL_surface.h>
 #include <string>
+#include <vector>
 #include "ColorRGB.h"
+#include "MipChain.h"
+#include "Vector2.h"
+
+struct SDL_Surface;
 
 namespace dae
 {
-	struct Vector2;
+	// Channel byte to [0, 1], the same values as dividing by 255 at sampling time
+	inline constexpr std::array<float, 256> BYTE_TO_FLOAT = []()
+		{
+			std::array<float, 256> values{};
+
+			for (int value{ 0 }; value < 256; ++value)
+			{
+				values[value] = value / 255.0f;
+			}
+
+			return values;
+		}();
+
+	// Texels packed as RGBA8, red in the lowest byte, the byte order of SDL_PIXELFORMAT_RGBA32 read as one word
+	struct ColorTexelTraits
+	{
+		using Value = ColorRGB;
+
+		static ColorRGB Decode(uint32_t texel)
+		{
+			return ColorRGB{ BYTE_TO_FLOAT[texel & 0xff], BYTE_TO_FLOAT[(texel >> 8) & 0xff], BYTE_TO_FLOAT[(texel >> 16) & 0xff] };
+		}
+
+		static ColorRGB Lerp(const ColorRGB& first, const ColorRGB& second, float factor)
+		{
+			return ColorRGB::Lerp(first, second, factor);
+		}
+	};
 
+	// Sampling is inline through MipChain, it runs for every shaded pixel
 	class Texture
 	{
 	public:
 		~Texture();
 
-		static std::unique_ptr<Texture> LoadFromFile(const std::string& path);
+		static std::unique_ptr<Texture> LoadFromFile(const std::string& path, TextureLayout layout = TextureLayout::Linear);
 		ColorRGB Sample(const Vector2& uv) const;
 
+		// uvDdx and uvDdy are the change in uv to the next pixel on the right and below
+		ColorRGB Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, TextureFilter filter) const;
+
+		// Raw texels for building other texture types from this one, packed RGBA8 with red in the lowest byte
+		int GetLevelCount() const;
+		int GetWidth(int level) const;
+		int GetHeight(int level) const;
+		uint32_t GetTexel(int level, int x, int y) const;
+
 	private:
-		Texture(SDL_Surface* pSurface);
+		using MipLevel = MipChain<uint32_t, ColorTexelTraits>::Level;
+
+		// pSurface has to be SDL_PIXELFORMAT_RGBA32 already, LoadFromFile converts it
+		Texture(SDL_Surface* pSurface, TextureLayout layout);
+
+		// Level 0 is the loaded image, every next level is half the size down to 1x1
+		MipChain<uint32_t, ColorTexelTraits> m_MipChain{};
 
-		SDL_Surface* m_pSurface{ nullptr };
-		uint32_t* m_pSurfacePixels{ nullptr };
+		static void CreateMipLevels(std::vector<MipLevel>& mipLevels);
 	};
-}
\ No newline at end of file
+
+	inline ColorRGB Texture::Sample(const Vector2& uv) const
+	{
+		return m_MipChain.SampleNearest(0, uv);
+	}
+
+	inline ColorRGB Texture::Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, TextureFilter filter) const
+	{
+		return m_MipChain.Sample(uv, uvDdx, uvDdy, filter);
+	}
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <cassert>
 #include <fstream>
+#include <algorithm>
+#include <unordered_map>
 #include "Maths.h"
 #include "DataTypes.h"
 
@@ -10,10 +12,149 @@ namespace dae
 {
 	namespace Utils
 	{
-		//Just parses vertices and indices
+		// How much sharing face corners saved, every corner used to be a vertex of its own
+		struct ObjStatistics
+		{
+			uint32_t faceCorners{};
+			uint32_t uniqueVertices{};
+
+			// Read back from a mesh cache instead of parsed
+			bool isFromCache{};
+		};
+
+		// The 1-based position, uv and normal index of a face corner, 0 when the corner leaves it out
+		struct ObjCorner
+		{
+			uint32_t position{};
+			uint32_t uv{};
+			uint32_t normal{};
+
+			bool operator==(const ObjCorner&) const = default;
+		};
+
+		struct ObjCornerHash
+		{
+			size_t operator()(const ObjCorner& corner) const
+			{
+				size_t hash = corner.position;
+				hash = hash * 0x9E3779B97F4A7C15ull ^ corner.uv;
+				hash = hash * 0x9E3779B97F4A7C15ull ^ corner.normal;
+
+				return hash ^ (hash >> 32);
+			}
+		};
+
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
-		static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
+		//Turns the corners of the triangles into vertices and indices, corners with the same position, uv and normal share one vertex
+		//Fails when a corner points past the attributes that were read
+		inline bool BuildVertices(const std::vector<Vector3>& positions, const std::vector<Vector2>& UVs, const std::vector<Vector3>& normals,
+			const std::vector<ObjCorner>& corners, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding, ObjStatistics* pStatistics)
+		{
+			vertices.clear();
+			indices.clear();
+			indices.reserve(corners.size());
+
+			// Index of the vertex made for every distinct corner so far
+			std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> cornerVertices{};
+			cornerVertices.reserve(positions.size() * 2);
+
+			for (size_t i = 0; i + 2 < corners.size(); i += 3)
+			{
+				uint32_t tempIndices[3];
+				for (size_t iFace = 0; iFace < 3; iFace++)
+				{
+					const ObjCorner& corner = corners[i + iFace];
+
+					if (corner.position == 0 || corner.position > positions.size() || corner.uv > UVs.size() || corner.normal > normals.size())
+						return false;
+
+					const auto [iterator, isNew] = cornerVertices.try_emplace(corner, uint32_t(vertices.size()));
+
+					if (isNew)
+					{
+						Vertex vertex{};
+						vertex.position = positions[corner.position - 1];
+
+						if (corner.uv != 0) vertex.uv = UVs[corner.uv - 1];
+						if (corner.normal != 0) vertex.normal = normals[corner.normal - 1];
+
+						vertices.push_back(vertex);
+					}
+
+					tempIndices[iFace] = iterator->second;
+				}
+
+				indices.push_back(tempIndices[0]);
+				if (flipAxisAndWinding)
+				{
+					indices.push_back(tempIndices[2]);
+					indices.push_back(tempIndices[1]);
+				}
+				else
+				{
+					indices.push_back(tempIndices[1]);
+					indices.push_back(tempIndices[2]);
+				}
+			}
+
+			//Cheap Tangent Calculations
+			for (uint32_t i = 0; i < indices.size(); i += 3)
+			{
+				uint32_t index0 = indices[i];
+				uint32_t index1 = indices[size_t(i) + 1];
+				uint32_t index2 = indices[size_t(i) + 2];
+
+				const Vector3& p0 = vertices[index0].position;
+				const Vector3& p1 = vertices[index1].position;
+				const Vector3& p2 = vertices[index2].position;
+				const Vector2& uv0 = vertices[index0].uv;
+				const Vector2& uv1 = vertices[index1].uv;
+				const Vector2& uv2 = vertices[index2].uv;
+
+				const Vector3 edge0 = p1 - p0;
+				const Vector3 edge1 = p2 - p0;
+				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
+				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
+				const float uvArea = Vector2::Cross(diffX, diffY);
+
+				// Without a uv area there is no tangent, and shared vertices would pass the NaN on to their neighbours
+				if (uvArea == 0.f)
+					continue;
+
+				float r = 1.f / uvArea;
+
+				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
+				vertices[index0].tangent += tangent;
+				vertices[index1].tangent += tangent;
+				vertices[index2].tangent += tangent;
+			}
+
+			if (pStatistics)
+			{
+				pStatistics->faceCorners = uint32_t(indices.size());
+				pStatistics->uniqueVertices = uint32_t(vertices.size());
+			}
+
+			//Fix the tangents per vertex now because we accumulated
+			for (auto& v : vertices)
+			{
+				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
+
+				if(flipAxisAndWinding)
+				{
+					v.position.z *= -1.f;
+					v.normal.z *= -1.f;
+					v.tangent.z *= -1.f;
+				}
+
+			}
+
+			return true;
+		}
+
+		//Parses vertices and indices, corners with the same position, uv and normal share one vertex
+		inline bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true, ObjStatistics* pStatistics = nullptr)
 		{
 #ifdef DISABLE_OBJ
 
@@ -30,16 +171,13 @@ namespace dae
 			std::vector<Vector3> positions{};
 			std::vector<Vector3> normals{};
 			std::vector<Vector2> UVs{};
-
-			vertices.clear();
-			indices.clear();
+			std::vector<ObjCorner> corners{};
 
 			std::string sCommand;
-			// start a while iteration ending when the end of file is reached (ios::eof)
-			while (!file.eof())
+			// start a while iteration ending when no first word can be read anymore, at the end of the file
+			//read the first word of the string, use the >> operator (istream::operator>>) 
+			while (file >> sCommand)
 			{
-				//read the first word of the string, use the >> operator (istream::operator>>) 
-				file >> sCommand;
 				//use conditional statements to process the different commands	
 				if (sCommand == "#")
 				{
@@ -76,15 +214,12 @@ namespace dae
 					//add the material index as attibute to the attribute array
 					//
 					// Faces or triangles
-					Vertex vertex{};
-					size_t iPosition, iTexCoord, iNormal;
-
-					uint32_t tempIndices[3];
 					for (size_t iFace = 0; iFace < 3; iFace++)
 					{
+						ObjCorner corner{};
+
 						// OBJ format uses 1-based arrays
-						file >> iPosition;
-						vertex.position = positions[iPosition - 1];
+						file >> corner.position;
 
 						if ('/' == file.peek())//is next in buffer ==  '/' ?
 						{
@@ -93,8 +228,7 @@ namespace dae
 							if ('/' != file.peek())
 							{
 								// Optional texture coordinate
-								file >> iTexCoord;
-								vertex.uv = UVs[iTexCoord - 1];
+								file >> corner.uv;
 							}
 
 							if ('/' == file.peek())
@@ -102,74 +236,40 @@ namespace dae
 								file.ignore();
 
 								// Optional vertex normal
-								file >> iNormal;
-								vertex.normal = normals[iNormal - 1];
+								file >> corner.normal;
 							}
 						}
 
-						vertices.push_back(vertex);
-						tempIndices[iFace] = uint32_t(vertices.size()) - 1;
-						//indices.push_back(uint32_t(vertices.size()) - 1);
-					}
-
-					indices.push_back(tempIndices[0]);
-					if (flipAxisAndWinding) 
-					{
-						indices.push_back(tempIndices[2]);
-						indices.push_back(tempIndices[1]);
-					}
-					else
-					{
-						indices.push_back(tempIndices[1]);
-						indices.push_back(tempIndices[2]);
+						corners.push_back(corner);
 					}
 				}
 				//read till end of line and ignore all remaining chars
 				file.ignore(1000, '\n');
 			}
 
-			//Cheap Tangent Calculations
-			for (uint32_t i = 0; i < indices.size(); i += 3)
-			{
-				uint32_t index0 = indices[i];
-				uint32_t index1 = indices[size_t(i) + 1];
-				uint32_t index2 = indices[size_t(i) + 2];
-
-				const Vector3& p0 = vertices[index0].position;
-				const Vector3& p1 = vertices[index1].position;
-				const Vector3& p2 = vertices[index2].position;
-				const Vector2& uv0 = vertices[index0].uv;
-				const Vector2& uv1 = vertices[index1].uv;
-				const Vector2& uv2 = vertices[index2].uv;
+			return BuildVertices(positions, UVs, normals, corners, vertices, indices, flipAxisAndWinding, pStatistics);
+#endif
+		}
 
-				const Vector3 edge0 = p1 - p0;
-				const Vector3 edge1 = p2 - p0;
-				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
-				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-				float r = 1.f / Vector2::Cross(diffX, diffY);
+		inline BoundingBox CalculateBoundingBox(const std::vector<Vertex>& vertices)
+		{
+			if (vertices.empty())
+				return BoundingBox{};
 
-				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-				vertices[index0].tangent += tangent;
-				vertices[index1].tangent += tangent;
-				vertices[index2].tangent += tangent;
-			}
+			BoundingBox bounds{ vertices[0].position, vertices[0].position };
 
-			//Fix the tangents per vertex now because we accumulated
-			for (auto& v : vertices)
+			for (const Vertex& vertex : vertices)
 			{
-				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
-
-				if(flipAxisAndWinding)
-				{
-					v.position.z *= -1.f;
-					v.normal.z *= -1.f;
-					v.tangent.z *= -1.f;
-				}
+				bounds.minimum.x = std::min(bounds.minimum.x, vertex.position.x);
+				bounds.minimum.y = std::min(bounds.minimum.y, vertex.position.y);
+				bounds.minimum.z = std::min(bounds.minimum.z, vertex.position.z);
 
+				bounds.maximum.x = std::max(bounds.maximum.x, vertex.position.x);
+				bounds.maximum.y = std::max(bounds.maximum.y, vertex.position.y);
+				bounds.maximum.z = std::max(bounds.maximum.z, vertex.position.z);
 			}
 
-			return true;
-#endif
+			return bounds;
 		}
 #pragma warning(pop)
 	}
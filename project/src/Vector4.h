@@ -1,10 +1,17 @@
 #pragma once
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+#include "MathHelpers.h"
+#include "Vector2.h"
+#include "Vector3.h"
 
 namespace dae
 {
-	struct Vector2;
-	struct Vector3;
-	struct Vector4
+	// Aligned like an SSE register, the arithmetic loads all four components at once
+	// Every lane rounds exactly like the scalar operation it replaces, so results do not change
+	struct alignas(16) Vector4
 	{
 		float x;
 		float y;
@@ -12,16 +19,19 @@ namespace dae
 		float w;
 
 		Vector4() = default;
-		Vector4(float _x, float _y, float _z, float _w);
-		Vector4(const Vector3& v, float _w);
+		constexpr Vector4(float _x, float _y, float _z, float _w);
+		constexpr Vector4(const Vector3& v, float _w);
+		explicit Vector4(__m128 v);
+
+		__m128 ToSimd() const;
 
 		float Magnitude() const;
 		float SqrMagnitude() const;
 		float Normalize();
 		Vector4 Normalized() const;
 
-		Vector2 GetXY() const;
-		Vector3 GetXYZ() const;
+		constexpr Vector2 GetXY() const;
+		constexpr Vector3 GetXYZ() const;
 
 		static float Dot(const Vector4& v1, const Vector4& v2);
 
@@ -30,9 +40,135 @@ namespace dae
 		Vector4 operator+(const Vector4& v) const;
 		Vector4 operator-(const Vector4& v) const;
 		Vector4& operator+=(const Vector4& v);
-		float& operator[](int index);
-		float operator[](int index) const;
+		constexpr float& operator[](int index);
+		constexpr float operator[](int index) const;
 		bool operator==(const Vector4& v) const;
 		Vector4 operator/(float scale) const;
 	};
+
+	constexpr Vector4::Vector4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+	constexpr Vector4::Vector4(const Vector3& v, float _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
+
+	inline Vector4::Vector4(__m128 v)
+	{
+		_mm_store_ps(&x, v);
+	}
+
+	inline __m128 Vector4::ToSimd() const
+	{
+		return _mm_load_ps(&x);
+	}
+
+	inline float Vector4::Magnitude() const
+	{
+		return sqrtf(SqrMagnitude());
+	}
+
+	inline float Vector4::SqrMagnitude() const
+	{
+		return Dot(*this, *this);
+	}
+
+	inline float Vector4::Normalize()
+	{
+		const float m = Magnitude();
+		*this = *this / m;
+
+		return m;
+	}
+
+	inline Vector4 Vector4::Normalized() const
+	{
+		const float m = Magnitude();
+		return *this / m;
+	}
+
+	constexpr Vector2 Vector4::GetXY() const
+	{
+		return { x, y };
+	}
+
+	constexpr Vector3 Vector4::GetXYZ() const
+	{
+		return { x,y,z };
+	}
+
+	inline float Vector4::Dot(const Vector4& v1, const Vector4& v2)
+	{
+		// The products are summed from x to w, in the same order as v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w
+		const __m128 products = _mm_mul_ps(v1.ToSimd(), v2.ToSimd());
+
+		__m128 sum = _mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1, 1, 1, 1)));
+		sum = _mm_add_ss(sum, _mm_movehl_ps(products, products));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(products, products, _MM_SHUFFLE(3, 3, 3, 3)));
+
+		return _mm_cvtss_f32(sum);
+	}
+
+#pragma region Operator Overloads
+	inline Vector4 Vector4::operator*(float scale) const
+	{
+		return Vector4{ _mm_mul_ps(ToSimd(), _mm_set1_ps(scale)) };
+	}
+
+	inline Vector4 Vector4::operator+(const Vector4& v) const
+	{
+		return Vector4{ _mm_add_ps(ToSimd(), v.ToSimd()) };
+	}
+
+	inline Vector4 Vector4::operator-(const Vector4& v) const
+	{
+		return Vector4{ _mm_sub_ps(ToSimd(), v.ToSimd()) };
+	}
+
+	inline Vector4& Vector4::operator+=(const Vector4& v)
+	{
+		_mm_store_ps(&x, _mm_add_ps(ToSimd(), v.ToSimd()));
+		return *this;
+	}
+
+	constexpr float& Vector4::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+
+		if (index == 0)return x;
+		if (index == 1)return y;
+		if (index == 2)return z;
+		return w;
+	}
+
+	constexpr float Vector4::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+
+		if (index == 0)return x;
+		if (index == 1)return y;
+		if (index == 2)return z;
+		return w;
+	}
+
+	inline bool Vector4::operator==(const Vector4& v) const
+	{
+		return AreEqual(x, v.x, .000001f) && AreEqual(y, v.y, .000001f) && AreEqual(z, v.z, .000001f) && AreEqual(w, v.w, .000001f);
+	}
+
+	inline Vector4 Vector4::operator/(float scale) const
+	{
+		return Vector4{ _mm_div_ps(ToSimd(), _mm_set1_ps(scale)) };
+	}
+
+#pragma endregion
+
+	// The members of Vector3 that need the full Vector4
+	constexpr Vector3::Vector3(const Vector4& v) : x(v.x), y(v.y), z(v.z){}
+
+	constexpr Vector4 Vector3::ToPoint4() const
+	{
+		return { x, y, z, 1 };
+	}
+
+	constexpr Vector4 Vector3::ToVector4() const
+	{
+		return { x, y, z, 0 };
+	}
 }
@@ -0,0 +1,117 @@
+#include "VertexBuffer.h"
+
+#include "DataTypes.h"
+
+namespace dae
+{
+	void VertexBuffer::Assign(const std::vector<Vertex>& vertices)
+	{
+		for (int axis{ 0 }; axis < 3; ++axis)
+		{
+			position[axis].resize(vertices.size());
+			normal[axis].resize(vertices.size());
+			tangent[axis].resize(vertices.size());
+		}
+
+		uv[0].resize(vertices.size());
+		uv[1].resize(vertices.size());
+
+		for (size_t index{ 0 }; index < vertices.size(); ++index)
+		{
+			const Vertex& vertex = vertices[index];
+
+			for (int axis{ 0 }; axis < 3; ++axis)
+			{
+				position[axis][index] = vertex.position[axis];
+				normal[axis][index] = vertex.normal[axis];
+				tangent[axis][index] = vertex.tangent[axis];
+			}
+
+			uv[0][index] = vertex.uv.x;
+			uv[1][index] = vertex.uv.y;
+		}
+	}
+
+	size_t VertexBuffer::Size() const
+	{
+		return position[0].size();
+	}
+
+	VertexInputStreams VertexBuffer::GetStreams() const
+	{
+		return VertexInputStreams
+		{
+			{ position[0].data(), position[1].data(), position[2].data() },
+			{ uv[0].data(), uv[1].data() },
+			{ normal[0].data(), normal[1].data(), normal[2].data() },
+			{ tangent[0].data(), tangent[1].data(), tangent[2].data() }
+		};
+	}
+
+	void TransformedVertexBuffer::Resize(size_t size)
+	{
+		for (AlignedVector<float>& stream : clip) stream.resize(size);
+		for (AlignedVector<float>& stream : raster) stream.resize(size);
+		for (AlignedVector<float>& stream : uv) stream.resize(size);
+		for (AlignedVector<float>& stream : normal) stream.resize(size);
+		for (AlignedVector<float>& stream : tangent) stream.resize(size);
+		for (AlignedVector<float>& stream : viewDirection) stream.resize(size);
+	}
+
+	void TransformedVertexBuffer::Clear()
+	{
+		Resize(0);
+	}
+
+	size_t TransformedVertexBuffer::Size() const
+	{
+		return clip[0].size();
+	}
+
+	void TransformedVertexBuffer::PushBack(const Vector4& clipPosition, const Vertex_Out& vertex)
+	{
+		for (int axis{ 0 }; axis < 3; ++axis)
+		{
+			clip[axis].push_back(clipPosition[axis]);
+			raster[axis].push_back(vertex.position[axis]);
+			normal[axis].push_back(vertex.normal[axis]);
+			tangent[axis].push_back(vertex.tangent[axis]);
+			viewDirection[axis].push_back(vertex.viewDirection[axis]);
+		}
+
+		clip[3].push_back(clipPosition.w);
+		uv[0].push_back(vertex.uv.x);
+		uv[1].push_back(vertex.uv.y);
+	}
+
+	Vertex_Out TransformedVertexBuffer::GetVertex(size_t index) const
+	{
+		Vertex_Out vertex{};
+
+		vertex.position = Vector4{ raster[0][index], raster[1][index], raster[2][index], clip[3][index] };
+		vertex.uv = Vector2{ uv[0][index], uv[1][index] };
+		vertex.normal = Vector3{ normal[0][index], normal[1][index], normal[2][index] };
+		vertex.tangent = Vector3{ tangent[0][index], tangent[1][index], tangent[2][index] };
+		vertex.viewDirection = Vector3{ viewDirection[0][index], viewDirection[1][index], viewDirection[2][index] };
+
+		return vertex;
+	}
+
+	Vector4 TransformedVertexBuffer::GetClipPosition(size_t index) const
+	{
+		return Vector4{ clip[0][index], clip[1][index], clip[2][index], clip[3][index] };
+	}
+
+	VertexOutputStreams TransformedVertexBuffer::GetStreams()
+	{
+		return VertexOutputStreams
+		{
+			{ clip[0].data(), clip[1].data(), clip[2].data(), clip[3].data() },
+			{ raster[0].data(), raster[1].data(), raster[2].data() },
+			{ uv[0].data(), uv[1].data() },
+			{ normal[0].data(), normal[1].data(), normal[2].data() },
+			{ tangent[0].data(), tangent[1].data(), tangent[2].data() },
+			{ viewDirection[0].data(), viewDirection[1].data(), viewDirection[2].data() }
+		};
+	}
+}
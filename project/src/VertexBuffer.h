@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "Maths.h"
+#include "RasterKernels.h"
+
+namespace dae
+{
+	struct Vertex;
+	struct Vertex_Out;
+
+	// Object space vertices of a mesh with one aligned array per component, filled once after loading
+	struct VertexBuffer
+	{
+		AlignedVector<float> position[3]{};
+		AlignedVector<float> uv[2]{};
+		AlignedVector<float> normal[3]{};
+		AlignedVector<float> tangent[3]{};
+
+		void Assign(const std::vector<Vertex>& vertices);
+		size_t Size() const;
+
+		VertexInputStreams GetStreams() const;
+	};
+
+	// Vertices of a mesh after the vertex stage, refilled every frame and extended with the corners made by clipping
+	struct TransformedVertexBuffer
+	{
+		AlignedVector<float> clip[4]{};
+		AlignedVector<float> raster[3]{};
+		AlignedVector<float> uv[2]{};
+		AlignedVector<float> normal[3]{};
+		AlignedVector<float> tangent[3]{};
+		AlignedVector<float> viewDirection[3]{};
+
+		void Resize(size_t size);
+		void Clear();
+		size_t Size() const;
+
+		// The position of the vertex is its raster position, together with the undivided w
+		void PushBack(const Vector4& clipPosition, const Vertex_Out& vertex);
+		Vertex_Out GetVertex(size_t index) const;
+		Vector4 GetClipPosition(size_t index) const;
+
+		VertexOutputStreams GetStreams();
+	};
+}
@@ -8,8 +8,12 @@
 
 //Standard includes
 #include <iostream>
+#include <memory>
 
 //Project includes
+#include "CpuFeatures.h"
+#include "FrameBenchmark.h"
+#include "Profiler.h"
 #include "Timer.h"
 #include "Renderer.h"
 
@@ -23,9 +27,9 @@ void ShutDown(SDL_Window* pWindow)
 
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	//Pick the kernels for this CPU before anything renders
+	const InstructionSet instructionSet = CpuFeatures::SelectInstructionSet(argc, args);
+	std::cout << "Kernels: " << CpuFeatures::GetName(instructionSet) << std::endl;
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
@@ -46,13 +50,34 @@ int main(int argc, char* args[])
 	const auto pTimer = new Timer();
 	const auto pRenderer = new Renderer(pWindow);
 
+	//Start Benchmark, it replaces input and the timer with a camera path
+	std::unique_ptr<FrameBenchmark> pBenchmark{};
+	BenchmarkSettings benchmarkSettings{};
+
+	if (FrameBenchmark::ParseSettings(argc, args, benchmarkSettings))
+	{
+		pBenchmark = FrameBenchmark::Create(benchmarkSettings);
+
+		if (!pBenchmark)
+		{
+			delete pRenderer;
+			delete pTimer;
+
+			ShutDown(pWindow);
+			return 1;
+		}
+	}
+
+	//Recording a camera path for the benchmark, toggled with F1
+	CameraPath recordedPath{};
+	bool isRecording = false;
+	float recordingTime = 0.f;
+
 	//Start loop
 	pTimer->Start();
 
-	// Start Benchmark
-	// TODO pTimer->StartBenchmark();
-
 	float printTimer = 0.f;
+	int result = 0;
 	bool isLooping = true;
 	bool takeScreenshot = false;
 	while (isLooping)
@@ -72,6 +97,47 @@ int main(int argc, char* args[])
 					takeScreenshot = true;
 					break;
 				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_F1)
+				{
+					// The benchmark drives the pose at its own timestep, recording it would only copy the path back
+					if (pBenchmark)
+					{
+						std::cout << "Camera path recording is off while benchmarking" << std::endl;
+						break;
+					}
+
+					isRecording = !isRecording;
+
+					if (isRecording)
+					{
+						recordedPath.Clear();
+						recordingTime = 0.f;
+						std::cout << "Recording camera path" << std::endl;
+					}
+					else if (recordedPath.SaveToFile("camera_path.txt"))
+						std::cout << "Camera path saved to camera_path.txt" << std::endl;
+					else
+						std::cout << "Something went wrong. Camera path not saved!" << std::endl;
+					break;
+				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_F2)
+				{
+					if (Profiler::WriteTrace("Rasterizer_Trace.json"))
+						std::cout << "Trace saved to Rasterizer_Trace.json" << std::endl;
+					else if (!Profiler::IsCompiledIn())
+						std::cout << "Profiler not compiled in, configure with ENABLE_PROFILER=ON" << std::endl;
+					else
+						std::cout << "Something went wrong. Trace not saved!" << std::endl;
+					break;
+				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_F3)
+				{
+					pRenderer->ToggleTextureFilter();
+					break;
+				}
+
 				if (e.key.keysym.scancode == SDL_SCANCODE_F4)
 				{
 					pRenderer->ToggleDepthBuffer();
@@ -95,22 +161,92 @@ int main(int argc, char* args[])
 					pRenderer->ToggleShadowMode();
 					break;
 				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_F8)
+				{
+					pRenderer->ToggleMultithreading();
+					break;
+				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_F9)
+				{
+					pRenderer->ToggleSimdRasterization();
+					break;
+				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_F10)
+				{
+					pRenderer->ToggleHiZ();
+					break;
+				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_F11)
+				{
+					pRenderer->ToggleVisibilityBuffer();
+					break;
+				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_F12)
+				{
+					pRenderer->ToggleOverdrawView();
+					break;
+				}
+
+				if (e.key.keysym.scancode == SDL_SCANCODE_P)
+				{
+					pRenderer->ToggleFastPhong();
+					break;
+				}
 			}
 		}
 
 		//--------- Update ---------
-		pRenderer->Update(pTimer);
+		if (pBenchmark)
+			pBenchmark->BeginFrame(*pRenderer);
+		else
+			pRenderer->Update(pTimer);
+
+		if (isRecording)
+		{
+			CameraKeyframe keyframe = pRenderer->GetPose();
+			keyframe.time = recordingTime;
+			recordedPath.AddKeyframe(keyframe);
+		}
 
 		//--------- Render ---------
 		pRenderer->Render();
 
+		if (pBenchmark)
+		{
+			pBenchmark->EndFrame(*pRenderer);
+
+			if (pBenchmark->IsDone())
+			{
+				if (!pBenchmark->WriteReports())
+					result = 1;
+
+				isLooping = false;
+			}
+		}
+
 		//--------- Timer ---------
 		pTimer->Update();
+		recordingTime += pTimer->GetElapsed();
 		printTimer += pTimer->GetElapsed();
 		if (printTimer >= 1.f)
 		{
 			printTimer = 0.f;
 			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+
+			const Renderer::RenderStatistics& statistics = pRenderer->GetStatistics();
+			std::cout << "Triangles: " << statistics.submittedTriangles << " submitted, " << statistics.depthRangeTriangles << " outside the z-range, " << statistics.outsideTriangles << " outside the sides, "
+				<< statistics.clippedTriangles << " clipped, " << statistics.assembledTriangles << " assembled, " << statistics.culledTriangles << " culled, " << statistics.degenerateTriangles << " degenerate" << std::endl;
+			std::cout << "Culled: " << statistics.culledMeshes << " meshes" << std::endl;
+			std::cout << "HiZ rejected: " << statistics.rejectedTriangles << " triangles, " << statistics.rejectedBlocks << " blocks" << std::endl;
+			std::cout << "Pixels: " << statistics.testedPixels << " tested, " << statistics.coveragePasses << " inside, " << statistics.depthPasses << " passed depth, "
+				<< statistics.shadedFragments << " shaded, " << statistics.coveredPixels << " covered" << std::endl;
+			std::cout << "Shaded fragments per pixel: " << float(statistics.shadedFragments) / std::max(statistics.coveredPixels, 1u)
+				<< ", depth passes per pixel: " << float(statistics.depthPasses) / std::max(statistics.coveredPixels, 1u) << std::endl;
 		}
 
 		//Save screenshot after full render
@@ -130,5 +266,5 @@ int main(int argc, char* args[])
 	delete pTimer;
 
 	ShutDown(pWindow);
-	return 0;
+	return result;
 }
\ No newline at end of file
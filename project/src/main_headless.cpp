@@ -0,0 +1,180 @@
+//External includes
+#ifdef ENABLE_VLD
+#include "vld.h"
+#endif
+#include "SDL.h"
+#undef main
+
+//Standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+//Project includes
+#include "CpuFeatures.h"
+#include "FrameBenchmark.h"
+#include "Profiler.h"
+#include "Timer.h"
+#include "Renderer.h"
+
+using namespace dae;
+
+namespace
+{
+	bool TryParseArgument(const char* pArgument, const char* pPrefix, int& value)
+	{
+		const size_t prefixLength = std::strlen(pPrefix);
+
+		if (std::strncmp(pArgument, pPrefix, prefixLength) != 0)
+			return false;
+
+		value = std::atoi(pArgument + prefixLength);
+		return true;
+	}
+
+	bool TryParseArgument(const char* pArgument, const char* pPrefix, std::string& value)
+	{
+		const size_t prefixLength = std::strlen(pPrefix);
+
+		if (std::strncmp(pArgument, pPrefix, prefixLength) != 0)
+			return false;
+
+		value = pArgument + prefixLength;
+		return true;
+	}
+}
+
+// Renders a fixed number of frames offscreen and reports the frame time, for machines without a display
+// Only the timer, surfaces and image loading of SDL are used, the video subsystem is never initialized
+// Usage: Rasterizer_Headless [--width=<pixels>] [--height=<pixels>] [--frames=<count>] [--save] [--trace=<file>] [--isa=<name>] [--std-pow]
+// With --benchmark the frames follow a camera path instead, see FrameBenchmark for its arguments
+int main(int argc, char* args[])
+{
+	const InstructionSet instructionSet = CpuFeatures::SelectInstructionSet(argc, args);
+	std::cout << "Kernels: " << CpuFeatures::GetName(instructionSet) << std::endl;
+
+	int width = 640;
+	int height = 480;
+	int frameCount = 100;
+	bool saveImage = false;
+	bool isFastPhongOn = true;
+	std::string traceFile{};
+
+	for (int index{ 1 }; index < argc; ++index)
+	{
+		if (TryParseArgument(args[index], "--width=", width) || TryParseArgument(args[index], "--height=", height) || TryParseArgument(args[index], "--frames=", frameCount)
+			|| TryParseArgument(args[index], "--trace=", traceFile))
+			continue;
+
+		if (std::strcmp(args[index], "--save") == 0)
+			saveImage = true;
+
+		if (std::strcmp(args[index], "--std-pow") == 0)
+			isFastPhongOn = false;
+	}
+
+	if (width <= 0 || height <= 0 || frameCount <= 0)
+	{
+		std::cout << "Width, height and frames have to be positive" << std::endl;
+		return 1;
+	}
+
+	BenchmarkSettings benchmarkSettings{};
+	std::unique_ptr<FrameBenchmark> pBenchmark{};
+
+	if (FrameBenchmark::ParseSettings(argc, args, benchmarkSettings))
+	{
+		pBenchmark = FrameBenchmark::Create(benchmarkSettings);
+
+		if (!pBenchmark)
+			return 1;
+	}
+
+	//Initialize "framework"
+	const auto pTimer = new Timer();
+	const auto pRenderer = new Renderer(width, height);
+
+	// Shades the Phong term with std::pow, to compare against PowPolynomial
+	if (!isFastPhongOn)
+		pRenderer->ToggleFastPhong();
+
+	int result = 0;
+
+	if (pBenchmark)
+	{
+		std::cout << "Benchmarking " << benchmarkSettings.frameCount << " frames at " << width << "x" << height << std::endl;
+
+		while (!pBenchmark->IsDone())
+		{
+			pBenchmark->BeginFrame(*pRenderer);
+			pRenderer->Render();
+			pBenchmark->EndFrame(*pRenderer);
+		}
+
+		if (!pBenchmark->WriteReports())
+			result = 1;
+	}
+	else
+	{
+		std::cout << "Rendering " << frameCount << " frames at " << width << "x" << height << std::endl;
+
+		pTimer->Start();
+
+		for (int frame{ 0 }; frame < frameCount; ++frame)
+		{
+			pRenderer->Update(pTimer);
+			pRenderer->Render();
+
+			pTimer->Update();
+		}
+
+		pTimer->Stop();
+
+		const float totalTime = pTimer->GetTotal();
+		std::cout << "Total: " << totalTime << " s, " << totalTime * 1000.0f / frameCount << " ms per frame, " << frameCount / totalTime << " FPS" << std::endl;
+	}
+
+	const Renderer::RenderStatistics& statistics = pRenderer->GetStatistics();
+	std::cout << "Triangles: " << statistics.submittedTriangles << " submitted, " << statistics.depthRangeTriangles << " outside the z-range, " << statistics.outsideTriangles << " outside the sides, "
+		<< statistics.clippedTriangles << " clipped, " << statistics.assembledTriangles << " assembled, " << statistics.culledTriangles << " culled, " << statistics.degenerateTriangles << " degenerate" << std::endl;
+	std::cout << "Culled: " << statistics.culledMeshes << " meshes" << std::endl;
+	std::cout << "HiZ rejected: " << statistics.rejectedTriangles << " triangles, " << statistics.rejectedBlocks << " blocks" << std::endl;
+	std::cout << "Pixels: " << statistics.testedPixels << " tested, " << statistics.coveragePasses << " inside, " << statistics.depthPasses << " passed depth, "
+		<< statistics.shadedFragments << " shaded, " << statistics.coveredPixels << " covered" << std::endl;
+	std::cout << "Shaded fragments per pixel: " << float(statistics.shadedFragments) / std::max(statistics.coveredPixels, 1u)
+		<< ", depth passes per pixel: " << float(statistics.depthPasses) / std::max(statistics.coveredPixels, 1u) << std::endl;
+
+	//Save the last frame
+	if (saveImage)
+	{
+		if (!pRenderer->SaveBufferToImage())
+			std::cout << "Screenshot saved!" << std::endl;
+		else
+		{
+			std::cout << "Something went wrong. Screenshot not saved!" << std::endl;
+			result = 1;
+		}
+	}
+
+	//Timeline of the last frames
+	if (!traceFile.empty())
+	{
+		if (Profiler::WriteTrace(traceFile))
+			std::cout << "Trace saved to " << traceFile << std::endl;
+		else
+		{
+			std::cout << (Profiler::IsCompiledIn() ? "Something went wrong. Trace not saved!" : "Profiler not compiled in, configure with ENABLE_PROFILER=ON") << std::endl;
+			result = 1;
+		}
+	}
+
+	//Shutdown "framework"
+	delete pRenderer;
+	delete pTimer;
+
+	SDL_Quit();
+	return result;
+}
@@ -0,0 +1,421 @@
+//External includes
+#include "SDL.h"
+#undef main
+
+//Standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Project includes
+#include "CameraPath.h"
+#include "CpuFeatures.h"
+#include "RasterKernels.h"
+#include "Renderer.h"
+
+using namespace dae;
+
+namespace
+{
+	constexpr int WIDTH{ 640 };
+	constexpr int HEIGHT{ 480 };
+
+	// The buffer of the span check, a multiple of the span width, so no span sticks out of it
+	constexpr int BUFFER_WIDTH{ 128 };
+	constexpr int BUFFER_HEIGHT{ 128 };
+	constexpr int TRIANGLE_COUNT{ 4000 };
+
+	// Not a multiple of any register width, so the kernels run their tails as well
+	constexpr int VERTEX_COUNT{ 1003 };
+
+	struct RasterVertex
+	{
+		float x{};
+		float y{};
+		float z{};
+	};
+
+	bool IsSameFloat(float first, float second)
+	{
+		return std::memcmp(&first, &second, sizeof(float)) == 0;
+	}
+
+	float Cross(float firstX, float firstY, float secondX, float secondY)
+	{
+		return firstX * secondY - firstY * secondX;
+	}
+
+	// Triangles of every size and orientation, partly off the buffer, with their depths close to the far plane like those of the scene
+	std::vector<RasterVertex> CreateTriangles()
+	{
+		std::mt19937 generator{ 1 };
+		std::uniform_real_distribution<float> position{ -16.0f, float(BUFFER_WIDTH + 16) };
+		std::uniform_real_distribution<float> depth{ 0.95f, 1.0f };
+
+		std::vector<RasterVertex> vertices(TRIANGLE_COUNT * 3);
+
+		for (RasterVertex& vertex : vertices)
+		{
+			vertex = RasterVertex{ position(generator), position(generator), depth(generator) };
+		}
+
+		return vertices;
+	}
+
+	// Rasterizes the triangles into a depth buffer the way Renderer::RenderTriangle does, every kernel into a buffer of its own
+	// Returns the number of spans whose coverage, weights or depths differ from those of the reference kernel
+	int CountDifferentSpans(const std::vector<RasterVertex>& vertices, RasterKernels::CoverageSpanFunction coverageSpan, RasterKernels::CoverageSpanFunction referenceCoverageSpan)
+	{
+		std::vector<float> depthBuffer(BUFFER_WIDTH * BUFFER_HEIGHT, 1.0f);
+		std::vector<float> referenceDepthBuffer(BUFFER_WIDTH * BUFFER_HEIGHT, 1.0f);
+
+		PixelSpan span{};
+		PixelSpan referenceSpan{};
+
+		int count{};
+
+		for (size_t index{ 0 }; index < vertices.size(); index += 3)
+		{
+			RasterVertex V0 = vertices[index];
+			RasterVertex V1 = vertices[index + 1];
+			RasterVertex V2 = vertices[index + 2];
+
+			// Counter-clockwise triangles are turned around instead of skipped
+			float totalArea = Cross(V1.x - V0.x, V1.y - V0.y, V2.x - V0.x, V2.y - V0.y);
+
+			if (totalArea < 0.0f)
+			{
+				std::swap(V1, V2);
+				totalArea = -totalArea;
+			}
+
+			if (totalArea == 0.0f)
+			{
+				continue;
+			}
+
+			const int minX = int(std::clamp(std::min({ V0.x, V1.x, V2.x }), 0.0f, float(BUFFER_WIDTH - 1)));
+			const int minY = int(std::clamp(std::min({ V0.y, V1.y, V2.y }), 0.0f, float(BUFFER_HEIGHT - 1)));
+			const int maxX = int(std::clamp(std::ceil(std::max({ V0.x, V1.x, V2.x })), 0.0f, float(BUFFER_WIDTH - 1)));
+			const int maxY = int(std::clamp(std::ceil(std::max({ V0.y, V1.y, V2.y })), 0.0f, float(BUFFER_HEIGHT - 1)));
+
+			const float edgeX[3]{ V2.x - V1.x, V0.x - V2.x, V1.x - V0.x };
+			const float edgeY[3]{ V2.y - V1.y, V0.y - V2.y, V1.y - V0.y };
+
+			const EdgeSetup edgeSetup
+			{
+				{ -edgeY[0], -edgeY[1], -edgeY[2] },
+				1 / totalArea,
+				{ V0.z, V1.z, V2.z }
+			};
+
+			const int spanMinX = minX - minX % RasterKernels::SPAN_WIDTH;
+			const float startX = spanMinX + 0.5f;
+			const float startY = minY + 0.5f;
+
+			float rowCross[3]
+			{
+				Cross(edgeX[0], edgeY[0], startX - V1.x, startY - V1.y),
+				Cross(edgeX[1], edgeY[1], startX - V2.x, startY - V2.y),
+				Cross(edgeX[2], edgeY[2], startX - V0.x, startY - V0.y)
+			};
+
+			for (int py{ minY }; py < maxY; ++py)
+			{
+				float spanCross[3]{ rowCross[0], rowCross[1], rowCross[2] };
+
+				for (int spanX{ spanMinX }; spanX < maxX; spanX += RasterKernels::SPAN_WIDTH)
+				{
+					const int firstLane = std::max(minX - spanX, 0);
+					const int lastLane = std::min(maxX - spanX, RasterKernels::SPAN_WIDTH);
+					const uint32_t laneMask = ((1u << lastLane) - 1) & ~((1u << firstLane) - 1);
+
+					const int spanIndex = py * BUFFER_WIDTH + spanX;
+
+					const uint32_t coverageMask = coverageSpan(edgeSetup, spanCross, &depthBuffer[spanIndex], laneMask, span);
+					const uint32_t referenceMask = referenceCoverageSpan(edgeSetup, spanCross, &referenceDepthBuffer[spanIndex], laneMask, referenceSpan);
+
+					// The inside mask is valid for every lane, the weights and the depth only for the covered ones
+					bool isSame = coverageMask == referenceMask && span.insideMask == referenceSpan.insideMask;
+
+					// Only the covered lanes are written
+					for (int lane{ 0 }; lane < RasterKernels::SPAN_WIDTH; ++lane)
+					{
+						if ((coverageMask & (1u << lane)) != 0)
+						{
+							depthBuffer[spanIndex + lane] = span.depth[lane];
+						}
+
+						if ((referenceMask & (1u << lane)) != 0)
+						{
+							referenceDepthBuffer[spanIndex + lane] = referenceSpan.depth[lane];
+						}
+
+						if (isSame && (coverageMask & (1u << lane)) != 0)
+						{
+							isSame = IsSameFloat(span.weights[0][lane], referenceSpan.weights[0][lane])
+								&& IsSameFloat(span.weights[1][lane], referenceSpan.weights[1][lane])
+								&& IsSameFloat(span.weights[2][lane], referenceSpan.weights[2][lane])
+								&& IsSameFloat(span.depth[lane], referenceSpan.depth[lane]);
+						}
+					}
+
+					count += isSame ? 0 : 1;
+
+					spanCross[0] += edgeSetup.stepX[0] * RasterKernels::SPAN_WIDTH;
+					spanCross[1] += edgeSetup.stepX[1] * RasterKernels::SPAN_WIDTH;
+					spanCross[2] += edgeSetup.stepX[2] * RasterKernels::SPAN_WIDTH;
+				}
+
+				rowCross[0] += edgeX[0];
+				rowCross[1] += edgeX[1];
+				rowCross[2] += edgeX[2];
+			}
+		}
+
+		return count;
+	}
+
+	// A projection that keeps w positive for every generated position, so every raster position is meaningful
+	VertexTransformSetup CreateVertexTransformSetup()
+	{
+		std::mt19937 generator{ 2 };
+		std::uniform_real_distribution<float> element{ -2.0f, 2.0f };
+
+		VertexTransformSetup setup{};
+
+		for (int index{ 0 }; index < 16; ++index)
+		{
+			setup.worldViewProjection[index] = element(generator);
+			setup.world[index] = element(generator);
+		}
+
+		setup.worldViewProjection[3] *= 0.01f;
+		setup.worldViewProjection[7] *= 0.01f;
+		setup.worldViewProjection[11] *= 0.01f;
+		setup.worldViewProjection[15] = 16.0f;
+
+		setup.cameraOrigin[0] = 0.0f;
+		setup.cameraOrigin[1] = 5.0f;
+		setup.cameraOrigin[2] = -64.0f;
+		setup.width = float(BUFFER_WIDTH);
+		setup.height = float(BUFFER_HEIGHT);
+
+		return setup;
+	}
+
+	// Every component in an array of its own, like VertexBuffer and TransformedVertexBuffer hold them
+	// The 11 input components come first, followed by the 18 the vertex stage writes
+	constexpr int INPUT_COMPONENT_COUNT{ 11 };
+	constexpr int COMPONENT_COUNT{ 29 };
+
+	struct VertexStreams
+	{
+		std::vector<float> components[COMPONENT_COUNT]{};
+
+		VertexInputStreams GetInput() const
+		{
+			return VertexInputStreams
+			{
+				{ components[0].data(), components[1].data(), components[2].data() },
+				{ components[3].data(), components[4].data() },
+				{ components[5].data(), components[6].data(), components[7].data() },
+				{ components[8].data(), components[9].data(), components[10].data() }
+			};
+		}
+
+		VertexOutputStreams GetOutput()
+		{
+			return VertexOutputStreams
+			{
+				{ components[11].data(), components[12].data(), components[13].data(), components[14].data() },
+				{ components[15].data(), components[16].data(), components[17].data() },
+				{ components[18].data(), components[19].data() },
+				{ components[20].data(), components[21].data(), components[22].data() },
+				{ components[23].data(), components[24].data(), components[25].data() },
+				{ components[26].data(), components[27].data(), components[28].data() }
+			};
+		}
+	};
+
+	// Positions within [-5, 5] and the other input components within [-1, 1]
+	VertexStreams CreateVertexStreams()
+	{
+		std::mt19937 generator{ 3 };
+		std::uniform_real_distribution<float> coordinate{ -5.0f, 5.0f };
+		std::uniform_real_distribution<float> component{ -1.0f, 1.0f };
+
+		VertexStreams streams{};
+
+		for (int index{ 0 }; index < COMPONENT_COUNT; ++index)
+		{
+			streams.components[index].resize(VERTEX_COUNT);
+
+			if (index < 3)
+				std::generate(streams.components[index].begin(), streams.components[index].end(), [&]() { return coordinate(generator); });
+			else if (index < INPUT_COMPONENT_COUNT)
+				std::generate(streams.components[index].begin(), streams.components[index].end(), [&]() { return component(generator); });
+		}
+
+		return streams;
+	}
+
+	// Returns the number of vertices with any output that differs from the one of the reference kernel
+	int CountDifferentVertices(RasterKernels::TransformVerticesFunction transformVertices, RasterKernels::TransformVerticesFunction referenceTransformVertices)
+	{
+		const VertexTransformSetup setup = CreateVertexTransformSetup();
+
+		VertexStreams streams = CreateVertexStreams();
+		VertexStreams referenceStreams = streams;
+
+		transformVertices(setup, streams.GetInput(), streams.GetOutput(), 0, VERTEX_COUNT);
+		referenceTransformVertices(setup, referenceStreams.GetInput(), referenceStreams.GetOutput(), 0, VERTEX_COUNT);
+
+		int count{};
+
+		for (int index{ 0 }; index < VERTEX_COUNT; ++index)
+		{
+			bool isSame = true;
+
+			for (int component{ INPUT_COMPONENT_COUNT }; component < COMPONENT_COUNT; ++component)
+			{
+				isSame = isSame && IsSameFloat(streams.components[component][index], referenceStreams.components[component][index]);
+			}
+
+			count += isSame ? 0 : 1;
+		}
+
+		return count;
+	}
+
+	// The color and depth buffer of one frame
+	struct Frame
+	{
+		std::vector<uint32_t> pixels{};
+		std::vector<float> depths{};
+	};
+
+	Frame CaptureFrame(const Renderer& renderer)
+	{
+		const uint32_t* pPixels = renderer.GetBackBufferPixels();
+		const float* pDepths = renderer.GetDepthBuffer();
+
+		return Frame{ { pPixels, pPixels + WIDTH * HEIGHT }, { pDepths, pDepths + WIDTH * HEIGHT } };
+	}
+
+	// Pixels whose color or depth is not bit for bit the same
+	int CountDifferentPixels(const Frame& frame, const Frame& reference)
+	{
+		int count{};
+
+		for (size_t index{ 0 }; index < frame.pixels.size(); ++index)
+		{
+			if (frame.pixels[index] != reference.pixels[index] || !IsSameFloat(frame.depths[index], reference.depths[index]))
+			{
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	// Prints the result of one comparison, returns false when it differs
+	bool Report(const std::string& name, InstructionSet instructionSet, int differences, const char* pUnit)
+	{
+		std::cout << name << ", " << CpuFeatures::GetName(instructionSet) << ": ";
+
+		if (differences == 0)
+		{
+			std::cout << "same as scalar" << std::endl;
+			return true;
+		}
+
+		std::cout << differences << " " << pUnit << " DIFFER" << std::endl;
+		return false;
+	}
+}
+
+// Runs the kernels of every instruction set this machine can run and compares the results with those of the scalar kernels
+// First on generated triangles and vertices, then on whole frames of the vehicle and the tuktuk, in forward and in visibility buffer mode
+// The SIMD kernels have to round exactly like the scalar ones, so every value, color and depth has to match bit for bit
+// Usage: Rasterizer_KernelCheck [--isa=<name>], checks up to the given or the detected instruction set and exits with 1 on any difference
+int main(int argc, char* args[])
+{
+	const InstructionSet lastInstructionSet = CpuFeatures::SelectInstructionSet(argc, args);
+	std::cout << "Kernels: scalar up to " << CpuFeatures::GetName(lastInstructionSet) << std::endl;
+
+	const std::vector<RasterVertex> vertices = CreateTriangles();
+	const RasterKernels::KernelTable referenceKernels = RasterKernels::GetKernelTable(InstructionSet::Scalar);
+
+	int result = 0;
+
+	for (int instructionSet{ int(InstructionSet::Scalar) + 1 }; instructionSet <= int(lastInstructionSet); ++instructionSet)
+	{
+		const RasterKernels::KernelTable kernels = RasterKernels::GetKernelTable(InstructionSet(instructionSet));
+
+		if (!Report("Coverage span", InstructionSet(instructionSet), CountDifferentSpans(vertices, kernels.coverageSpan, referenceKernels.coverageSpan), "SPANS"))
+			result = 1;
+
+		if (!Report("Vertex transform", InstructionSet(instructionSet), CountDifferentVertices(kernels.transformVertices, referenceKernels.transformVertices), "VERTICES"))
+			result = 1;
+	}
+
+	const char* meshFilenames[]{ "resources/vehicle.obj", "resources/tuktuk.obj" };
+
+	// From afar, close enough to clip the near plane, and from the side
+	const CameraKeyframe poses[]
+	{
+		CameraKeyframe{ 0.0f, { 0.0f, 5.0f, -64.0f }, 0.0f, 0.0f, 0.0f },
+		CameraKeyframe{ 0.0f, { 0.0f, 5.0f, -8.0f }, 0.0f, 0.0f, 0.5f },
+		CameraKeyframe{ 0.0f, { -30.0f, 10.0f, -20.0f }, 0.2f, 1.0f, 2.5f }
+	};
+
+	for (const char* pMeshFilename : meshFilenames)
+	{
+		Renderer renderer{ WIDTH, HEIGHT };
+
+		if (!renderer.LoadMesh(pMeshFilename))
+		{
+			result = 1;
+			continue;
+		}
+
+		// The visibility buffer shades after the raster stage, so both paths get their own frames
+		for (const bool isVisibilityBufferOn : { false, true })
+		{
+			if (isVisibilityBufferOn)
+				renderer.ToggleVisibilityBuffer();
+
+			for (int poseIndex{ 0 }; poseIndex < int(std::size(poses)); ++poseIndex)
+			{
+				renderer.SetPose(poses[poseIndex]);
+
+				renderer.SetInstructionSet(InstructionSet::Scalar);
+				renderer.Render();
+				const Frame reference = CaptureFrame(renderer);
+
+				const std::string frameName = std::string{ pMeshFilename } + ", pose " + std::to_string(poseIndex) + (isVisibilityBufferOn ? ", visibility buffer" : ", forward");
+
+				for (int instructionSet{ int(InstructionSet::Scalar) + 1 }; instructionSet <= int(lastInstructionSet); ++instructionSet)
+				{
+					renderer.SetInstructionSet(InstructionSet(instructionSet));
+					renderer.Render();
+
+					if (!Report(frameName, InstructionSet(instructionSet), CountDifferentPixels(CaptureFrame(renderer), reference), "PIXELS"))
+						result = 1;
+				}
+			}
+		}
+	}
+
+	std::cout << (result == 0 ? "Every kernel matches the scalar one" : "FAILED") << std::endl;
+
+	SDL_Quit();
+	return result;
+}